@@ -0,0 +1,127 @@
+//
+//  KorgSyncEstimator.c
+//  WIST SDK Version 1.0.0
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <string.h>
+#include "KorgSyncEstimator.h"
+
+#define kMaxOnewayNano          4000000000ULL   //  4 sec.
+#define kStableJitterNano       1000000.0       //  1 msec.
+#define kBurstIntervalNano      20000000ULL
+#define kSettleIntervalNano     50000000ULL
+#define kStableIntervalNano     250000000ULL
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorReset
+//  ---------------------------------------------------------------------------
+void
+KorgSyncEstimatorReset(KorgSyncEstimator* estimator)
+{
+    memset(estimator, 0, sizeof(KorgSyncEstimator));
+    estimator->burstRemaining = kKorgSyncBurstBeacons;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorRequestBurst
+//  ---------------------------------------------------------------------------
+void
+KorgSyncEstimatorRequestBurst(KorgSyncEstimator* estimator)
+{
+    estimator->burstRemaining = kKorgSyncBurstBeacons;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorAddBeacon
+//  ---------------------------------------------------------------------------
+int
+KorgSyncEstimatorAddBeacon(KorgSyncEstimator* estimator, uint64_t sentNano, uint64_t remoteReceivedNano,
+                           uint64_t remoteSentNano, uint64_t receivedNano)
+{
+    //  time spent in the peer is not part of the round trip
+    const uint64_t  remoteNano = (remoteSentNano > remoteReceivedNano) ? remoteSentNano - remoteReceivedNano : 0;
+    const uint64_t  elapseNano = receivedNano - sentNano;
+    const uint64_t  roundTrip = (elapseNano > remoteNano) ? elapseNano - remoteNano : 0;
+    const uint64_t  elapseOnewayNano = roundTrip / 2;
+    if ((receivedNano < sentNano) || (elapseOnewayNano >= kMaxOnewayNano))
+    {
+        return 0;
+    }
+    if (estimator->worstDelay < elapseOnewayNano)
+    {
+        estimator->worstDelay = elapseOnewayNano;
+    }
+
+    KorgSyncSample* sample = &estimator->samples[estimator->nextSample];
+    sample->offset = (((double)remoteReceivedNano - (double)sentNano) + ((double)remoteSentNano - (double)receivedNano)) / 2;
+    sample->roundTrip = roundTrip;
+    estimator->nextSample = (estimator->nextSample + 1) % kKorgSyncWindow;
+    if (estimator->numberOfSamples < kKorgSyncWindow)
+    {
+        ++estimator->numberOfSamples;
+    }
+    if (estimator->burstRemaining > 0)
+    {
+        --estimator->burstRemaining;
+    }
+
+    //  pick the best round trips of the window
+    int     used[kKorgSyncWindow];
+    memset(used, 0, sizeof(used));
+    const int   numOfBest = (estimator->numberOfSamples < kKorgSyncBestSamples) ? estimator->numberOfSamples : kKorgSyncBestSamples;
+    double  sum = 0, minOffset = 0, maxOffset = 0;
+    for (int bestNo = 0; bestNo < numOfBest; ++bestNo)
+    {
+        int best = -1;
+        for (int index = 0; index < estimator->numberOfSamples; ++index)
+        {
+            if (!used[index] && ((best < 0) || (estimator->samples[index].roundTrip < estimator->samples[best].roundTrip)))
+            {
+                best = index;
+            }
+        }
+        used[best] = 1;
+        const double    offset = estimator->samples[best].offset;
+        sum += offset;
+        minOffset = ((bestNo == 0) || (offset < minOffset)) ? offset : minOffset;
+        maxOffset = ((bestNo == 0) || (offset > maxOffset)) ? offset : maxOffset;
+    }
+    estimator->timeDiff = sum / numOfBest;
+    estimator->jitter = maxOffset - minOffset;
+    estimator->beaconReceived = 1;
+    return 1;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorIsStable
+//  ---------------------------------------------------------------------------
+int
+KorgSyncEstimatorIsStable(const KorgSyncEstimator* estimator)
+{
+    return (estimator->numberOfSamples >= kKorgSyncWindow) && (estimator->jitter < kStableJitterNano);
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorBeaconInterval
+//  ---------------------------------------------------------------------------
+uint64_t
+KorgSyncEstimatorBeaconInterval(const KorgSyncEstimator* estimator)
+{
+    if ((estimator->burstRemaining > 0) || (estimator->numberOfSamples < kKorgSyncWindow))
+    {
+        return kBurstIntervalNano;
+    }
+    return KorgSyncEstimatorIsStable(estimator) ? kStableIntervalNano : kSettleIntervalNano;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncEstimatorToRemote
+//  ---------------------------------------------------------------------------
+uint64_t
+KorgSyncEstimatorToRemote(const KorgSyncEstimator* estimator, uint64_t localNano)
+{
+    return (uint64_t)(localNano + estimator->timeDiff);
+}
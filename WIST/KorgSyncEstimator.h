@@ -0,0 +1,68 @@
+//
+//  KorgSyncEstimator.h
+//  WIST SDK Version 1.0.0
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Clock offset between master and slave from the beacon round trips.
+//  Plain C so that the offline tools run the same code as KorgWirelessSyncStart.
+//
+//  Each beacon gives an offset sample ((t2 - t1) + (t3 - t4)) / 2 where t1 / t4 are the
+//  local send / receive times and t2 / t3 the remote receive / send times. Samples with a
+//  long round trip are the most likely to be asymmetric, so the offset is the mean of the
+//  best round trips of the last kKorgSyncWindow beacons, and their spread (jitter) tells
+//  when the estimate has settled and the beacon rate can back off.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    kKorgSyncWindow = 16,           //  beacons
+    kKorgSyncBestSamples = 4,       //  of the window, by round trip
+    kKorgSyncBurstBeacons = 24,     //  after a reset or a burst request
+};
+
+typedef struct {
+    double      offset;
+    uint64_t    roundTrip;
+} KorgSyncSample;
+
+typedef struct {
+    double      timeDiff;       //  remote clock - local clock, nanosec
+    uint64_t    worstDelay;     //  largest one way delay seen, nanosec
+    int         beaconReceived;
+    double      jitter;         //  spread of the offsets of the best round trips, nanosec
+    KorgSyncSample  samples[kKorgSyncWindow];
+    int         numberOfSamples;
+    int         nextSample;
+    int         burstRemaining;
+} KorgSyncEstimator;
+
+void    KorgSyncEstimatorReset(KorgSyncEstimator* estimator);
+void    KorgSyncEstimatorRequestBurst(KorgSyncEstimator* estimator);
+
+//  local sentNano / receivedNano, remote remoteReceivedNano / remoteSentNano (pass remoteSentNano
+//  for both if the peer only stamps once); returns 0 if the beacon is rejected
+int     KorgSyncEstimatorAddBeacon(KorgSyncEstimator* estimator, uint64_t sentNano, uint64_t remoteReceivedNano,
+                                   uint64_t remoteSentNano, uint64_t receivedNano);
+
+//  enough beacons with a small jitter to start in sync
+int     KorgSyncEstimatorIsStable(const KorgSyncEstimator* estimator);
+
+//  nanosec to the next beacon : dense while bursting or unsettled, sparse once stable
+uint64_t    KorgSyncEstimatorBeaconInterval(const KorgSyncEstimator* estimator);
+
+//  local nanosec -> remote nanosec
+uint64_t    KorgSyncEstimatorToRemote(const KorgSyncEstimator* estimator, uint64_t localNano);
+
+#ifdef __cplusplus
+}
+#endif
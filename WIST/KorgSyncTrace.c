@@ -0,0 +1,177 @@
+//
+//  KorgSyncTrace.c
+//  WIST SDK Version 1.0.0
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "KorgSyncTrace.h"
+
+//
+//  The writers reserve a record number by CAS on writeIndex, fill the slot and publish
+//  it by storing its sequence last. The flush writes slots in order up to the first one
+//  not published yet and then releases them by advancing readIndex.
+//
+struct KorgSyncTrace
+{
+    KorgSyncTraceRecord*    records;
+    uint32_t            capacity;
+    volatile uint32_t   writeIndex;
+    volatile uint32_t   readIndex;
+    volatile uint32_t   droppedCount;
+    uint32_t            reportedDroppedCount;
+    volatile int        isOpen;
+    FILE*               file;
+};
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceCreate
+//  ---------------------------------------------------------------------------
+KorgSyncTrace*
+KorgSyncTraceCreate(uint32_t capacity)
+{
+    KorgSyncTrace*  trace = (KorgSyncTrace*)calloc(1, sizeof(KorgSyncTrace));
+    if (trace == NULL)
+    {
+        return NULL;
+    }
+    trace->capacity = 2;
+    while (trace->capacity < capacity)
+    {
+        trace->capacity <<= 1;
+    }
+    trace->records = (KorgSyncTraceRecord*)calloc(trace->capacity, sizeof(KorgSyncTraceRecord));
+    if (trace->records == NULL)
+    {
+        free(trace);
+        return NULL;
+    }
+    return trace;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceDestroy
+//  ---------------------------------------------------------------------------
+void
+KorgSyncTraceDestroy(KorgSyncTrace* trace)
+{
+    if (trace != NULL)
+    {
+        KorgSyncTraceClose(trace);
+        free(trace->records);
+        free(trace);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceOpen
+//  ---------------------------------------------------------------------------
+int
+KorgSyncTraceOpen(KorgSyncTrace* trace, const char* path)
+{
+    KorgSyncTraceClose(trace);
+    trace->file = fopen(path, "wb");
+    if (trace->file == NULL)
+    {
+        return 0;
+    }
+    const KorgSyncTraceHeader   header = { kKorgSyncTraceMagic, kKorgSyncTraceVersion, sizeof(KorgSyncTraceRecord), 0 };
+    fwrite(&header, sizeof(header), 1, trace->file);
+    trace->reportedDroppedCount = trace->droppedCount;
+    __sync_synchronize();
+    trace->isOpen = 1;
+    return 1;
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceClose
+//  ---------------------------------------------------------------------------
+void
+KorgSyncTraceClose(KorgSyncTrace* trace)
+{
+    if (trace->file != NULL)
+    {
+        trace->isOpen = 0;
+        __sync_synchronize();
+        KorgSyncTraceFlush(trace);
+        fclose(trace->file);
+        trace->file = NULL;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceFlush
+//  ---------------------------------------------------------------------------
+void
+KorgSyncTraceFlush(KorgSyncTrace* trace)
+{
+    uint32_t    readIndex = trace->readIndex;
+    while (readIndex != trace->writeIndex)
+    {
+        const KorgSyncTraceRecord*  record = &trace->records[readIndex & (trace->capacity - 1)];
+        if (record->sequence != readIndex + 1)
+        {
+            break;  //  still being written
+        }
+        __sync_synchronize();
+        if (trace->file != NULL)
+        {
+            fwrite(record, sizeof(KorgSyncTraceRecord), 1, trace->file);
+        }
+        ++readIndex;
+        __sync_synchronize();
+        trace->readIndex = readIndex;
+    }
+
+    const uint32_t  droppedCount = trace->droppedCount;
+    if ((trace->file != NULL) && (droppedCount != trace->reportedDroppedCount))
+    {
+        KorgSyncTraceRecord record;
+        memset(&record, 0, sizeof(record));
+        record.type = kKorgSyncTrace_Dropped;
+        record.value[0] = droppedCount;
+        fwrite(&record, sizeof(record), 1, trace->file);
+        trace->reportedDroppedCount = droppedCount;
+    }
+    if (trace->file != NULL)
+    {
+        fflush(trace->file);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      KorgSyncTraceAppend
+//  ---------------------------------------------------------------------------
+void
+KorgSyncTraceAppend(KorgSyncTrace* trace, uint64_t timeNano, uint32_t type,
+                    int64_t value0, int64_t value1, int64_t value2, int64_t value3)
+{
+    if ((trace == NULL) || !trace->isOpen)
+    {
+        return;
+    }
+    uint32_t    index;
+    do
+    {
+        index = trace->writeIndex;
+        if (index - trace->readIndex >= trace->capacity)
+        {
+            __sync_fetch_and_add(&trace->droppedCount, 1);
+            return;
+        }
+    } while (!__sync_bool_compare_and_swap(&trace->writeIndex, index, index + 1));
+
+    KorgSyncTraceRecord*    record = &trace->records[index & (trace->capacity - 1)];
+    record->timeNano = timeNano;
+    record->type = type;
+    record->value[0] = value0;
+    record->value[1] = value1;
+    record->value[2] = value2;
+    record->value[3] = value3;
+    __sync_synchronize();
+    record->sequence = index + 1;
+}
@@ -0,0 +1,76 @@
+//
+//  KorgSyncTrace.h
+//  WIST SDK Version 1.0.0
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Binary trace of the sync measurements. Records are appended lock free into a
+//  preallocated ring from any thread and written to the file by KorgSyncTraceFlush()
+//  on a thread that may block. A record that does not fit into the ring is dropped
+//  and the number of dropped records is written with the next flush.
+//
+//  File : KorgSyncTraceHeader, then KorgSyncTraceRecord until the end (native byte order).
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    kKorgSyncTraceMagic = 0x57495354,   //  'WIST'
+    kKorgSyncTraceVersion = 1,
+};
+
+//
+//  record type, all times in local nanosec
+//
+enum
+{
+    kKorgSyncTrace_Reset = 0,       //  connection state reset
+    kKorgSyncTrace_Beacon,          //  value : sentNano, remoteSentNano, receivedNano, remoteReceivedNano
+                                    //  (remoteSentNano again if the peer only stamps when it sends)
+    kKorgSyncTrace_Delay,           //  value : delay, peerDelay
+    kKorgSyncTrace_Latency,         //  value : latency, peerLatency
+    kKorgSyncTrace_Start,           //  value : master start nano, slaveNanoSec sent, timeDiff, worstDelay
+    kKorgSyncTrace_Stop,            //  value : same as start
+    kKorgSyncTrace_Dropped,         //  value : number of records dropped so far
+};
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    recordSize;
+    uint32_t    reserved;
+} KorgSyncTraceHeader;
+
+typedef struct {
+    uint64_t    timeNano;       //  when the record was taken
+    uint32_t    type;
+    uint32_t    sequence;       //  record number + 1
+    int64_t     value[4];
+} KorgSyncTraceRecord;
+
+typedef struct KorgSyncTrace KorgSyncTrace;
+
+//  capacity : records, rounded up to a power of two
+KorgSyncTrace*  KorgSyncTraceCreate(uint32_t capacity);
+void    KorgSyncTraceDestroy(KorgSyncTrace* trace);
+
+//  flush thread
+int     KorgSyncTraceOpen(KorgSyncTrace* trace, const char* path);  //  0 : failed
+void    KorgSyncTraceClose(KorgSyncTrace* trace);
+void    KorgSyncTraceFlush(KorgSyncTrace* trace);
+
+//  any thread, never blocks; ignored while no file is open
+void    KorgSyncTraceAppend(KorgSyncTrace* trace, uint64_t timeNano, uint32_t type,
+                            int64_t value0, int64_t value1, int64_t value2, int64_t value3);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,6 +9,10 @@
 #import <UIKit/UIKit.h>
 #import <MultipeerConnectivity/MultipeerConnectivity.h>
 #import <stdint.h>
+#import <pthread.h>
+#import <mach/semaphore.h>
+#import "KorgSyncEstimator.h"
+#import "KorgSyncTrace.h"
 
 @protocol KorgWirelessSyncStartDelegate <NSObject>
 
@@ -43,13 +47,23 @@ extern NSString * const kMCBrowserDismissNotification;
     uint64_t    delay_;
     uint64_t    peerDelay_;
     BOOL        gotPeerDelay_;
-    uint64_t    gkWorstDelay_;
-    BOOL        beaconReceived_;
-    double      timeDiff_;
+    KorgSyncEstimator   estimator_;
     uint64_t    latency_;
     uint64_t    peerLatency_;
     BOOL        gotPeerLatency_;
-    NSTimer*    timer_;
+    pthread_t       syncThread_;        //  beacons, requests and trace flush
+    semaphore_t     syncWake_;
+    volatile BOOL   syncQuit_;
+    BOOL            isSyncThreadRunning_;
+    pthread_mutex_t syncMutex_;         //  estimator_, beaconStamps_, isConnected_, isMaster_ and gotPeer*
+    struct {
+        uint64_t    stampedNano;        //  the time in the beacon
+        uint64_t    sentNano;           //  right before it was handed to the session
+    }               beaconStamps_[8];
+    uint32_t        beaconCount_;
+    uint64_t        lastRequestNano_;
+    KorgSyncTrace*      trace_;
+    dispatch_queue_t    traceQueue_;    //  file I/O of the trace
 }
 
 @property (nonatomic, strong) MCBrowserViewController *browser;
@@ -61,6 +75,7 @@ extern NSString * const kMCBrowserDismissNotification;
 @property (nonatomic) uint64_t latency;     //  unit:nanosec
 @property (nonatomic, readonly) BOOL isConnected;   //  connection status
 @property (nonatomic, readonly) BOOL isMaster;      //  YES:master, NO:slave
+@property (nonatomic, readonly) BOOL isSyncReady;   //  [master] clock offset settled, a start will be in sync
 
 
 -(void)setupPeerAndSessionWithDisplayName:(NSString *)displayName;
@@ -73,6 +88,8 @@ extern NSString * const kMCBrowserDismissNotification;
 - (void)searchPeer;
 //  disconnect
 - (void)disconnect;
+//  stop the sync thread and disconnect, call before releasing the object; it cannot be used afterwards
+- (void)invalidate;
 
 //  [master] send a command to slave
 - (void)sendStartCommand:(uint64_t)hostTime withTempo:(float)tempo;
@@ -81,4 +98,8 @@ extern NSString * const kMCBrowserDismissNotification;
 //  [master] calculate host time for local sequencer
 - (uint64_t)estimatedLocalHostTime:(uint64_t)hostTime;
 
+//  binary trace of the sync measurements (see KorgSyncTrace.h)
+- (BOOL)startTrace:(NSString*)path;
+- (void)stopTrace;
+
 @end
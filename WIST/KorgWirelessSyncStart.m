@@ -33,7 +33,14 @@ NSString * const kMCBrowserDismissNotification = @"BrowserDismissNotification";
 
 - (void)resetTime;
 - (void)forceDisconnect;
-- (void)timerFired:(NSTimer*)timer;
+- (uint64_t)syncTick;
+- (void)sendBeacon;
+- (void)requestBeaconBurst;
+- (void)startSyncThread;
+- (void)stopSyncThread;
+- (void)runSyncThread;
+- (void)wakeSyncThread;
+- (void)trace:(uint32_t)type value0:(int64_t)value0 value1:(int64_t)value1 value2:(int64_t)value2 value3:(int64_t)value3;
 
 @end
 
@@ -57,6 +64,19 @@ enum
     kGKCommand_Delay                = 7,
 };
 
+//  ---------------------------------------------------------------------------
+//      syncThreadEntry
+//  ---------------------------------------------------------------------------
+static void*
+syncThreadEntry(void* arg)
+{
+    //  not retained, a strong reference here would keep the object alive forever;
+    //  invalidate (or dealloc) joins the thread before the object goes away
+    __unsafe_unretained KorgWirelessSyncStart*  sync = (__bridge KorgWirelessSyncStart*)arg;
+    [sync runSyncThread];
+    return NULL;
+}
+
 #pragma mark - Init, dealloc and reset methods
 
 //  ---------------------------------------------------------------------------
@@ -71,11 +91,17 @@ enum
         isMaster_ = NO;
         doDisconnectByMyself_ = NO;
 
+        trace_ = KorgSyncTraceCreate(4096);
+        traceQueue_ = dispatch_queue_create("com.korg.wist.trace", DISPATCH_QUEUE_SERIAL);
+        pthread_mutex_init(&syncMutex_, NULL);
+        beaconCount_ = 0;
+        lastRequestNano_ = 0;
         [self resetTime];
 
-        const NSTimeInterval    interval = 1.0 / 8.0;
-        timer_ = [NSTimer scheduledTimerWithTimeInterval:interval target:self selector:@selector(timerFired:) userInfo:nil repeats:YES];
-        
+        semaphore_create(mach_task_self(), &syncWake_, SYNC_POLICY_FIFO, 0);
+        isSyncThreadRunning_ = NO;
+        [self startSyncThread];
+
         _peerID = nil;
         _session = nil;
         _browser = nil;
@@ -90,9 +116,17 @@ enum
 //  ---------------------------------------------------------------------------
 - (void)dealloc
 {
-    [timer_ invalidate];
+    [self stopSyncThread];  //  already stopped if the owner called invalidate
+    semaphore_destroy(mach_task_self(), syncWake_);
     [self forceDisconnect];
 
+    KorgSyncTrace*  trace = trace_;
+    trace_ = NULL;
+    dispatch_sync(traceQueue_, ^{
+        KorgSyncTraceDestroy(trace);
+    });
+
+    pthread_mutex_destroy(&syncMutex_);
     self.delegate = nil;
 }
 
@@ -103,13 +137,15 @@ enum
 {
     delay_ = 0;
     peerDelay_ = 0;
-    gotPeerDelay_ = NO;
-    gkWorstDelay_ = 0;
-    beaconReceived_ = NO;
     latency_ = 0;
     peerLatency_ = 0;
+    pthread_mutex_lock(&syncMutex_);
+    gotPeerDelay_ = NO;
     gotPeerLatency_ = NO;
-    timeDiff_ = 0;
+    KorgSyncEstimatorReset(&estimator_);
+    pthread_mutex_unlock(&syncMutex_);
+
+    [self trace:kKorgSyncTrace_Reset value0:0 value1:0 value2:0 value3:0];
 }
 
 //  ---------------------------------------------------------------------------
@@ -117,13 +153,15 @@ enum
 //  ---------------------------------------------------------------------------
 - (void)forceDisconnect
 {
-    const BOOL  prevStatus = isConnected_;
     doDisconnectByMyself_ = YES;
 
     [self.session disconnect];
     [self resetTime];
 
+    pthread_mutex_lock(&syncMutex_);
+    const BOOL  prevStatus = isConnected_;
     isConnected_ = NO;
+    pthread_mutex_unlock(&syncMutex_);
 
     if (prevStatus)
     {
@@ -195,9 +233,11 @@ enum
     if (latency_ != latencyNano)
     {
         latency_ = latencyNano;
+        [self trace:kKorgSyncTrace_Latency value0:latency_ value1:peerLatency_ value2:0 value3:0];
 
         if (isConnected_)
         {
+            [self requestBeaconBurst];
             NSArray*    commands = [NSArray arrayWithObjects:[NSNumber numberWithInt:kGKCommand_PeersLatencyChanged], nil];
             [self sendData:[NSKeyedArchiver archivedDataWithRootObject:commands] withDataMode:MCSessionSendDataReliable];
         }
@@ -212,7 +252,9 @@ enum
     if (!isConnected_)
     {
         doDisconnectByMyself_ = NO;
+        pthread_mutex_lock(&syncMutex_);
         isMaster_ = NO;
+        pthread_mutex_unlock(&syncMutex_);
     }
 }
 
@@ -224,6 +266,15 @@ enum
     [self forceDisconnect];
 }
 
+//  ---------------------------------------------------------------------------
+//      invalidate
+//  ---------------------------------------------------------------------------
+- (void)invalidate
+{
+    [self stopSyncThread];
+    [self forceDisconnect];
+}
+
 //  ---------------------------------------------------------------------------
 //      hostTime2NanoSec
 //  ---------------------------------------------------------------------------
@@ -268,12 +319,19 @@ nanoSec2HostTime(uint64_t nanosec)
             {
                 const uint64_t  latencyNano = [[array objectAtIndex:1] unsignedLongLongValue];
                 peerLatency_ = latencyNano;
+                pthread_mutex_lock(&syncMutex_);
                 gotPeerLatency_ = YES;
+                pthread_mutex_unlock(&syncMutex_);
+                [self trace:kKorgSyncTrace_Latency value0:self.latency value1:peerLatency_ value2:0 value3:0];
+                [self requestBeaconBurst];
             }
             break;
         case kGKCommand_PeersLatencyChanged:
             peerLatency_ = 0;
+            pthread_mutex_lock(&syncMutex_);
             gotPeerLatency_ = NO;
+            pthread_mutex_unlock(&syncMutex_);
+            [self wakeSyncThread];  //  ask for it now
             break;
         default:
             break;
@@ -283,7 +341,7 @@ nanoSec2HostTime(uint64_t nanosec)
 //  ---------------------------------------------------------------------------
 //      receiveDataInMasterMode
 //  ---------------------------------------------------------------------------
-- (void)receiveDataInMasterMode:(NSData *)data
+- (void)receiveDataInMasterMode:(NSData *)data receivedNano:(uint64_t)receivedNano
 {
     @try
     {
@@ -292,36 +350,37 @@ nanoSec2HostTime(uint64_t nanosec)
         switch(command)
         {
             case kGKCommand_Delay:
-                if (!gotPeerDelay_)
                 {
-                    peerDelay_ = [[array objectAtIndex:1] unsignedLongLongValue];
-                    gotPeerDelay_= YES;
+                    pthread_mutex_lock(&syncMutex_);
+                    const BOOL  isFirst = !gotPeerDelay_;
+                    gotPeerDelay_ = YES;
+                    pthread_mutex_unlock(&syncMutex_);
+                    if (isFirst)
+                    {
+                        peerDelay_ = [[array objectAtIndex:1] unsignedLongLongValue];
+                        [self trace:kKorgSyncTrace_Delay value0:delay_ value1:peerDelay_ value2:0 value3:0];
+                    }
                 }
                 break;
             case kGKCommand_Beacon:
                 {
-                    const uint64_t  sentNano = [[array objectAtIndex:1] unsignedLongLongValue];
+                    const uint64_t  stampedNano = [[array objectAtIndex:1] unsignedLongLongValue];
                     const uint64_t  remoteSentNano = [[array objectAtIndex:2] unsignedLongLongValue];
-                    const uint64_t  receivedNano = hostTime2NanoSec(mach_absolute_time());
-                    const uint64_t  elapseOnewayNano = (receivedNano - sentNano) / 2;
-                    if (elapseOnewayNano < 4000000000ULL)   //  < 4 sec.
+                    //  peers of an older version only stamp when they send
+                    const uint64_t  remoteReceivedNano = ([array count] > 3) ? [[array objectAtIndex:3] unsignedLongLongValue] : remoteSentNano;
+                    pthread_mutex_lock(&syncMutex_);
+                    uint64_t    sentNano = stampedNano;
+                    for (size_t index = 0; index < sizeof(beaconStamps_) / sizeof(beaconStamps_[0]); ++index)
                     {
-                        if (gkWorstDelay_ < elapseOnewayNano)
-                        {
-                            gkWorstDelay_ = elapseOnewayNano;
-                        }
-
-                        const double    diff = (double)remoteSentNano - elapseOnewayNano - sentNano;
-                        if (beaconReceived_)
+                        if (beaconStamps_[index].stampedNano == stampedNano)
                         {
-                            timeDiff_ = (timeDiff_ + diff) / 2;
-                        }
-                        else
-                        {
-                            timeDiff_ = diff;
-                            beaconReceived_ = YES;
+                            sentNano = beaconStamps_[index].sentNano;
+                            break;
                         }
                     }
+                    KorgSyncEstimatorAddBeacon(&estimator_, sentNano, remoteReceivedNano, remoteSentNano, receivedNano);
+                    pthread_mutex_unlock(&syncMutex_);
+                    [self trace:kKorgSyncTrace_Beacon value0:sentNano value1:remoteSentNano value2:receivedNano value3:remoteReceivedNano];
                 }
                 break;
             case kGKCommand_RequestLatency:
@@ -347,7 +406,7 @@ nanoSec2HostTime(uint64_t nanosec)
 //  ---------------------------------------------------------------------------
 //      receiveDataInSlaveMode
 //  ---------------------------------------------------------------------------
-- (void)receiveDataInSlaveMode:(NSData *)data
+- (void)receiveDataInSlaveMode:(NSData *)data receivedNano:(uint64_t)receivedNano
 {
     @try
     {
@@ -360,6 +419,7 @@ nanoSec2HostTime(uint64_t nanosec)
                     NSArray*    commands = [NSArray arrayWithObjects:[NSNumber numberWithInt:kGKCommand_Beacon],
                                             [NSNumber numberWithUnsignedLongLong:[[dataArray objectAtIndex:1] unsignedLongLongValue]],
                                             [NSNumber numberWithUnsignedLongLong:hostTime2NanoSec(mach_absolute_time())],
+                                            [NSNumber numberWithUnsignedLongLong:receivedNano],
                                             nil];
                     [self sendData:[NSKeyedArchiver archivedDataWithRootObject:commands] withDataMode:MCSessionSendDataUnreliable];
                 }
@@ -415,7 +475,10 @@ nanoSec2HostTime(uint64_t nanosec)
     const uint64_t  delayMax = (delay_ < peerDelay_) ? peerDelay_ : delay_;
     const uint64_t  audioLatencyMax = (self.latency < peerLatency_) ? peerLatency_ : self.latency;
     const uint64_t  latencyNano = audioLatencyMax - self.latency;
-    return hostTime + nanoSec2HostTime(gkWorstDelay_ + delayMax + latencyNano);
+    pthread_mutex_lock(&syncMutex_);
+    const uint64_t  worstDelay = estimator_.worstDelay;
+    pthread_mutex_unlock(&syncMutex_);
+    return hostTime + nanoSec2HostTime(worstDelay + delayMax + latencyNano);
 }
 
 //  ---------------------------------------------------------------------------
@@ -426,7 +489,10 @@ nanoSec2HostTime(uint64_t nanosec)
     const uint64_t  delayMax = (delay_ < peerDelay_) ? peerDelay_ : delay_;
     const uint64_t  audioLatencyMax = (self.latency < peerLatency_) ? peerLatency_ : self.latency;
     const uint64_t  latencyNano = audioLatencyMax - peerLatency_;
-    return hostTime + nanoSec2HostTime(gkWorstDelay_ + delayMax + latencyNano);
+    pthread_mutex_lock(&syncMutex_);
+    const uint64_t  worstDelay = estimator_.worstDelay;
+    pthread_mutex_unlock(&syncMutex_);
+    return hostTime + nanoSec2HostTime(worstDelay + delayMax + latencyNano);
 }
 
 //  ---------------------------------------------------------------------------
@@ -436,7 +502,12 @@ nanoSec2HostTime(uint64_t nanosec)
 {
     if (isConnected_ && isMaster_)
     {
-        const uint64_t  slaveNanoSec = beaconReceived_ ? (hostTime2NanoSec([self estimatedRemoteHostTime:hostTime]) + timeDiff_) : 0;
+        pthread_mutex_lock(&syncMutex_);
+        const KorgSyncEstimator estimator = estimator_;
+        pthread_mutex_unlock(&syncMutex_);
+        const uint64_t  slaveNanoSec = estimator.beaconReceived ? KorgSyncEstimatorToRemote(&estimator, hostTime2NanoSec([self estimatedRemoteHostTime:hostTime])) : 0;
+        [self trace:kKorgSyncTrace_Start value0:hostTime2NanoSec([self estimatedLocalHostTime:hostTime]) value1:slaveNanoSec
+             value2:(int64_t)estimator.timeDiff value3:estimator.worstDelay];
         NSArray*    commands = [NSArray arrayWithObjects:
                                 [NSNumber numberWithInt:kGKCommand_StartSlave],
                                 [NSNumber numberWithUnsignedLongLong:slaveNanoSec],
@@ -453,7 +524,12 @@ nanoSec2HostTime(uint64_t nanosec)
 {
     if (isConnected_ && isMaster_)
     {
-        const uint64_t  slaveNanoSec = beaconReceived_ ? (hostTime2NanoSec([self estimatedRemoteHostTime:hostTime]) + timeDiff_) : 0;
+        pthread_mutex_lock(&syncMutex_);
+        const KorgSyncEstimator estimator = estimator_;
+        pthread_mutex_unlock(&syncMutex_);
+        const uint64_t  slaveNanoSec = estimator.beaconReceived ? KorgSyncEstimatorToRemote(&estimator, hostTime2NanoSec([self estimatedRemoteHostTime:hostTime])) : 0;
+        [self trace:kKorgSyncTrace_Stop value0:hostTime2NanoSec([self estimatedLocalHostTime:hostTime]) value1:slaveNanoSec
+             value2:(int64_t)estimator.timeDiff value3:estimator.worstDelay];
         NSArray*    commands = [NSArray arrayWithObjects:
                                 [NSNumber numberWithInt:kGKCommand_StopSlave],
                                 [NSNumber numberWithUnsignedLongLong:slaveNanoSec],
@@ -462,47 +538,217 @@ nanoSec2HostTime(uint64_t nanosec)
     }
 }
 
+#pragma mark - Sync thread
 //  ---------------------------------------------------------------------------
-//      timerFired
+//      startSyncThread
 //  ---------------------------------------------------------------------------
-- (void)timerFired:(NSTimer*)timer
+- (void)startSyncThread
 {
-    //  send beacon
-    if (isConnected_)
+    //  beacons are timed off the main run loop, UI work must not delay them
+    syncQuit_ = NO;
+    pthread_attr_t  attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setschedpolicy(&attr, SCHED_RR);
+    struct sched_param  param;
+    param.sched_priority = sched_get_priority_max(SCHED_RR);
+    pthread_attr_setschedparam(&attr, &param);
+    isSyncThreadRunning_ = (pthread_create(&syncThread_, &attr, syncThreadEntry, (__bridge void*)self) == 0);
+    pthread_attr_destroy(&attr);
+}
+
+//  ---------------------------------------------------------------------------
+//      stopSyncThread
+//  ---------------------------------------------------------------------------
+- (void)stopSyncThread
+{
+    if (isSyncThreadRunning_)
     {
-        if (!gotPeerLatency_)
+        isSyncThreadRunning_ = NO;
+        syncQuit_ = YES;
+        [self wakeSyncThread];
+        pthread_join(syncThread_, NULL);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      isSyncReady
+//  ---------------------------------------------------------------------------
+- (BOOL)isSyncReady
+{
+    pthread_mutex_lock(&syncMutex_);
+    const BOOL  isReady = isConnected_ && isMaster_ && KorgSyncEstimatorIsStable(&estimator_);
+    pthread_mutex_unlock(&syncMutex_);
+    return isReady;
+}
+
+//  ---------------------------------------------------------------------------
+//      requestBeaconBurst
+//  ---------------------------------------------------------------------------
+//  re-measure densely, e.g. after connecting or a latency change
+- (void)requestBeaconBurst
+{
+    pthread_mutex_lock(&syncMutex_);
+    KorgSyncEstimatorRequestBurst(&estimator_);
+    pthread_mutex_unlock(&syncMutex_);
+    [self wakeSyncThread];
+}
+
+//  ---------------------------------------------------------------------------
+//      wakeSyncThread
+//  ---------------------------------------------------------------------------
+- (void)wakeSyncThread
+{
+    semaphore_signal(syncWake_);
+}
+
+//  ---------------------------------------------------------------------------
+//      sendBeacon
+//  ---------------------------------------------------------------------------
+- (void)sendBeacon
+{
+    const uint64_t  stampedNano = hostTime2NanoSec(mach_absolute_time());
+    NSArray*    commands = [NSArray arrayWithObjects:
+                            [NSNumber numberWithInt:kGKCommand_Beacon],
+                            [NSNumber numberWithUnsignedLongLong:stampedNano],
+                            nil];
+    NSData*     data = [NSKeyedArchiver archivedDataWithRootObject:commands];
+
+    //  the peer echoes stampedNano; the round trip starts when the data is handed to the session
+    const uint64_t  sentNano = hostTime2NanoSec(mach_absolute_time());
+    pthread_mutex_lock(&syncMutex_);
+    const size_t    slotNo = beaconCount_++ % (sizeof(beaconStamps_) / sizeof(beaconStamps_[0]));
+    beaconStamps_[slotNo].stampedNano = stampedNano;
+    beaconStamps_[slotNo].sentNano = sentNano;
+    pthread_mutex_unlock(&syncMutex_);
+    [self sendData:data withDataMode:MCSessionSendDataUnreliable];
+}
+
+//  ---------------------------------------------------------------------------
+//      syncTick
+//  ---------------------------------------------------------------------------
+//  returns nanosec to the next tick
+- (uint64_t)syncTick
+{
+    const uint64_t  kRequestIntervalNano = 125000000ULL;
+    const uint64_t  nowNano = hostTime2NanoSec(mach_absolute_time());
+    const BOOL      doRequest = (nowNano - lastRequestNano_ >= kRequestIntervalNano);
+    uint64_t        interval = kRequestIntervalNano;
+    if (doRequest)
+    {
+        lastRequestNano_ = nowNano;
+
+        //  write the trace off the receive path
+        KorgSyncTrace*  trace = trace_;
+        dispatch_async(traceQueue_, ^{
+            KorgSyncTraceFlush(trace);
+        });
+    }
+
+    //  written by the main and session threads
+    pthread_mutex_lock(&syncMutex_);
+    const BOOL  isConnected = isConnected_;
+    const BOOL  isMaster = isMaster_;
+    const BOOL  gotPeerLatency = gotPeerLatency_;
+    const BOOL  gotPeerDelay = gotPeerDelay_;
+    pthread_mutex_unlock(&syncMutex_);
+
+    if (isConnected)
+    {
+        if (!gotPeerLatency && doRequest)
         {
             NSArray*    request = [NSArray arrayWithObjects: [NSNumber numberWithInt:kGKCommand_RequestLatency], nil];
             [self sendData:[NSKeyedArchiver archivedDataWithRootObject:request] withDataMode:MCSessionSendDataReliable];
         }
-        if (isMaster_)
+        if (isMaster)
         {
-            if (!gotPeerDelay_)
+            if (!gotPeerDelay && doRequest)
             {
                 NSArray*    request = [NSArray arrayWithObjects: [NSNumber numberWithInt:kGKCommand_RequestDelay], nil];
                 [self sendData:[NSKeyedArchiver archivedDataWithRootObject:request] withDataMode:MCSessionSendDataReliable];
             }
+            [self sendBeacon];
+
+            pthread_mutex_lock(&syncMutex_);
+            interval = KorgSyncEstimatorBeaconInterval(&estimator_);
+            pthread_mutex_unlock(&syncMutex_);
+        }
+    }
+    return interval;
+}
 
-            NSArray*    commands = [NSArray arrayWithObjects:
-                                    [NSNumber numberWithInt:kGKCommand_Beacon],
-                                    [NSNumber numberWithUnsignedLongLong:hostTime2NanoSec(mach_absolute_time())],
-                                    nil];
-            [self sendData:[NSKeyedArchiver archivedDataWithRootObject:commands] withDataMode:MCSessionSendDataUnreliable];
+//  ---------------------------------------------------------------------------
+//      runSyncThread
+//  ---------------------------------------------------------------------------
+- (void)runSyncThread
+{
+    while (!syncQuit_)
+    {
+        uint64_t    interval;
+        @autoreleasepool
+        {
+            interval = [self syncTick];
         }
+        //  woken early by a burst request or quit
+        const mach_timespec_t   timeout = { (unsigned int)(interval / 1000000000ULL), (clock_res_t)(interval % 1000000000ULL) };
+        semaphore_timedwait(syncWake_, timeout);
+    }
+}
+
+#pragma mark - Trace
+//  ---------------------------------------------------------------------------
+//      startTrace
+//  ---------------------------------------------------------------------------
+- (BOOL)startTrace:(NSString*)path
+{
+    KorgSyncTrace*  trace = trace_;
+    const char*     filePath = [path fileSystemRepresentation];
+    __block int     result = 0;
+    dispatch_sync(traceQueue_, ^{
+        result = KorgSyncTraceOpen(trace, filePath);
+    });
+    if (result != 0)
+    {
+        [self trace:kKorgSyncTrace_Delay value0:delay_ value1:peerDelay_ value2:0 value3:0];
+        [self trace:kKorgSyncTrace_Latency value0:latency_ value1:peerLatency_ value2:0 value3:0];
     }
+    return (result != 0);
+}
+
+//  ---------------------------------------------------------------------------
+//      stopTrace
+//  ---------------------------------------------------------------------------
+- (void)stopTrace
+{
+    KorgSyncTrace*  trace = trace_;
+    dispatch_sync(traceQueue_, ^{
+        KorgSyncTraceClose(trace);
+    });
+}
+
+//  ---------------------------------------------------------------------------
+//      trace:value0:value1:value2:value3
+//  ---------------------------------------------------------------------------
+- (void)trace:(uint32_t)type value0:(int64_t)value0 value1:(int64_t)value1 value2:(int64_t)value2 value3:(int64_t)value3
+{
+    KorgSyncTraceAppend(trace_, hostTime2NanoSec(mach_absolute_time()), type, value0, value1, value2, value3);
 }
 
 #pragma mark - MCSessionDelegate
 
 - (void)session:(MCSession *)session didReceiveData:(NSData *)data fromPeer:(MCPeerID *)peerID
 {
-    if (isMaster_)
+    //  before anything else, unarchiving is part of what the beacon should not measure
+    const uint64_t  receivedNano = hostTime2NanoSec(mach_absolute_time());
+    pthread_mutex_lock(&syncMutex_);
+    const BOOL  isMaster = isMaster_;
+    pthread_mutex_unlock(&syncMutex_);
+    if (isMaster)
     {
-        [self receiveDataInMasterMode:data];
+        [self receiveDataInMasterMode:data receivedNano:receivedNano];
     }
     else
     {
-        [self receiveDataInSlaveMode:data];
+        [self receiveDataInSlaveMode:data receivedNano:receivedNano];
     }
 }
 
@@ -570,8 +816,11 @@ nanoSec2HostTime(uint64_t nanosec)
 
 - (void)browserViewControllerDidFinish:(MCBrowserViewController *)browserViewController
 {
+    pthread_mutex_lock(&syncMutex_);
     isMaster_ = YES;
     isConnected_ = YES;
+    pthread_mutex_unlock(&syncMutex_);
+    [self requestBeaconBurst];
     if (self.delegate && [self.delegate respondsToSelector:@selector(wistConnectionEstablished)])
     {
         [self.delegate performSelector:@selector(wistConnectionEstablished) withObject:nil];
@@ -581,7 +830,9 @@ nanoSec2HostTime(uint64_t nanosec)
 
 - (void)browserViewControllerWasCancelled:(MCBrowserViewController *)browserViewController
 {
+    pthread_mutex_lock(&syncMutex_);
     isMaster_ = NO;
+    pthread_mutex_unlock(&syncMutex_);
     if (self.delegate && [self.delegate respondsToSelector:@selector(wistConnectionCancelled)])
     {
         [self.delegate performSelector:@selector(wistConnectionCancelled) withObject:nil];
@@ -0,0 +1,177 @@
+//
+//  BlockFloatBenchmark.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Memory footprint and decode cost of block float samples against raw PCM.
+//  Build & run on the host:
+//
+//      c++ -O2 -I../Classes -o BlockFloatBenchmark BlockFloatBenchmark.cpp && ./BlockFloatBenchmark
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "DrumSample.h"
+#include "DrumSampleBlockFloat.h"
+
+//  ---------------------------------------------------------------------------
+//      MakeDrumHit
+//  ---------------------------------------------------------------------------
+//  decaying sine + noise, like a kick/snare layer, 16-bit interleaved
+static void
+MakeDrumHit(std::vector<int16_t>& pcm, uint32_t frames, int channels, float fs)
+{
+    pcm.resize(frames * channels);
+    ::srand(1);
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        const float t = frame / fs;
+        const float env = ::expf(-t * 6.0f);
+        const float body = ::sinf(2.0f * static_cast<float>(M_PI) * 60.0f * t) * env;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const float noise = (static_cast<float>(::rand()) / RAND_MAX * 2.0f - 1.0f) * env * env * 0.3f;
+            pcm[frame * channels + ch] = static_cast<int16_t>((body * 0.6f + noise) * 32767.0f);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      ElapsedNanoSec
+//  ---------------------------------------------------------------------------
+static double
+ElapsedNanoSec(clock_t start)
+{
+    return static_cast<double>(::clock() - start) * 1000000000.0 / CLOCKS_PER_SEC;
+}
+
+//  ---------------------------------------------------------------------------
+//      RenderCost
+//  ---------------------------------------------------------------------------
+//  ns per rendered frame, whole sample played at unity pitch in 64-frame blocks
+static double
+RenderCost(DrumSample& sample, int repeat)
+{
+    const int   kBlockLength = 64;
+    const int   stride = sample.GetNumberOfChannels();
+    std::vector<float>  output(kBlockLength * stride);
+    DrumDecodeCache cache;
+    uint64_t    renderedFrames = 0;
+    const clock_t   start = ::clock();
+    for (int count = 0; count < repeat; ++count)
+    {
+        DrumVoiceState  voice = { 0, 0x1000, 0x7FFF >> 2, 0x4000, true, &cache };
+        cache.blockNo = -1;
+        while (voice.isRunning)
+        {
+            sample.Render(voice, &output[0], stride, kBlockLength);
+            renderedFrames += kBlockLength;
+        }
+    }
+    return ElapsedNanoSec(start) / renderedFrames;
+}
+
+//  ---------------------------------------------------------------------------
+//      DecodeCost
+//  ---------------------------------------------------------------------------
+//  ns per decoded sample for the block decoder alone
+static double
+DecodeCost(const std::vector< BlockFloatBlock<1> >& blocks, int repeat)
+{
+    int32_t dest[kBlockFloatFrames];
+    int64_t checksum = 0;
+    const clock_t   start = ::clock();
+    for (int count = 0; count < repeat; ++count)
+    {
+        for (size_t blockNo = 0; blockNo < blocks.size(); ++blockNo)
+        {
+            BlockFloatDecode(blocks[blockNo].low[0], blocks[blockNo].high[0], blocks[blockNo].shift[0], dest);
+            checksum += dest[count % kBlockFloatFrames];
+        }
+    }
+    const double    elapsed = ElapsedNanoSec(start);
+    if (checksum == 0x7FFFFFFFFFFFLL)
+    {
+        ::printf(" ");
+    }
+    return elapsed / (static_cast<double>(repeat) * blocks.size() * kBlockFloatFrames);
+}
+
+//  ---------------------------------------------------------------------------
+//      SignalToNoise
+//  ---------------------------------------------------------------------------
+static double
+SignalToNoise(const DrumSample& reference, const DrumSample& coded)
+{
+    const uint32_t  frames = reference.GetNumberOfFrames();
+    const int   channels = reference.GetNumberOfChannels();
+    std::vector<int32_t>    ref(frames * channels), dec(frames * channels);
+    reference.ReadFrames(&ref[0], 0, frames);
+    coded.ReadFrames(&dec[0], 0, frames);
+    double  signal = 0.0, noise = 0.0;
+    for (size_t index = 0; index < ref.size(); ++index)
+    {
+        signal += static_cast<double>(ref[index]) * ref[index];
+        noise += static_cast<double>(ref[index] - dec[index]) * (ref[index] - dec[index]);
+    }
+    return 10.0 * ::log10(signal / ((noise > 0.0) ? noise : 1.0));
+}
+
+//  ---------------------------------------------------------------------------
+//      Run
+//  ---------------------------------------------------------------------------
+template <int Channels>
+static void
+Run(float fs, uint32_t frames, int repeat)
+{
+    std::vector<int16_t>    pcm;
+    MakeDrumHit(pcm, frames, Channels, fs);
+    DrumSampleData<SampleFormatInt16, Channels> raw;
+    raw.Append(&pcm[0], frames);
+    DrumSampleBlockFloat<Channels>  compressed(raw);
+
+    ::printf("%s, %u frames\n", (Channels == 1) ? "mono" : "stereo", frames);
+    ::printf("  memory     raw int16 %8lu bytes, int24 %8lu bytes, block float %8lu bytes (%.2f:1 vs int16, %.2f:1 vs int24)\n",
+             static_cast<unsigned long>(raw.GetDataSize()), static_cast<unsigned long>(frames * Channels * 3),
+             static_cast<unsigned long>(compressed.GetDataSize()),
+             static_cast<double>(raw.GetDataSize()) / compressed.GetDataSize(),
+             static_cast<double>(frames * Channels * 3) / compressed.GetDataSize());
+    ::printf("  quality    %.1f dB SNR\n", SignalToNoise(raw, compressed));
+    ::printf("  render     raw int16 %6.2f ns/frame, block float %6.2f ns/frame\n",
+             RenderCost(raw, repeat), RenderCost(compressed, repeat));
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    const float fs = 44100.0f;
+    const uint32_t  frames = static_cast<uint32_t>(fs * 2);
+    const int   repeat = 50;
+    Run<1>(fs, frames, repeat);
+    Run<2>(fs, frames, repeat);
+
+    std::vector<int16_t>    pcm;
+    MakeDrumHit(pcm, frames, 1, fs);
+    DrumSampleData<SampleFormatInt16, 1>    raw;
+    raw.Append(&pcm[0], frames);
+    std::vector< BlockFloatBlock<1> >   blocks((frames + kBlockFloatFrames - 1) / kBlockFloatFrames);
+    std::vector<int32_t>    tmp(kBlockFloatFrames);
+    for (size_t blockNo = 0; blockNo < blocks.size(); ++blockNo)
+    {
+        const uint32_t  startFrame = static_cast<uint32_t>(blockNo * kBlockFloatFrames);
+        const uint32_t  blockFrames = std::min<uint32_t>(frames - startFrame, kBlockFloatFrames);
+        raw.ReadFrames(&tmp[0], startFrame, blockFrames);
+        BlockFloatEncode<1>(&tmp[0], blockFrames, blocks[blockNo]);
+    }
+    ::printf("block decode only\n");
+    ::printf("  %6.3f ns/sample\n", DecodeCost(blocks, repeat * 4));
+    return 0;
+}
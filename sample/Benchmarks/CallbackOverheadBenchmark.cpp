@@ -0,0 +1,107 @@
+//
+//  CallbackOverheadBenchmark.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Cost of one Synthesizer::ProcessReplacing() callback against the block size, split into
+//  a fixed part per callback and a part per frame (least squares fit of time = fixed + frames * perFrame).
+//  The fixed part is what low-latency mode pays 700+ times a second at 64 frames.
+//
+//  macOS, the drum samples are loaded from the directory of the executable:
+//
+//      c++ -O2 -I../Classes -I../../WIST -framework Foundation -framework AudioToolbox -framework Accelerate
+//          -o CallbackOverheadBenchmark CallbackOverheadBenchmark.cpp ../Classes/*.cpp ../Classes/DrumOscillator.mm
+//      cp ../Resources/wav/*.wav . && ./CallbackOverheadBenchmark
+//
+//  Linux, with the host loader of the tests (reads ../Resources/wav):
+//
+//      make -C ../Tests benchmark
+//
+
+#include <mach/mach_time.h>
+#include <stdio.h>
+#include <vector>
+#if defined(__APPLE__)
+#include <TargetConditionals.h>
+#if !TARGET_OS_IPHONE
+#include <AudioToolbox/AudioToolbox.h>
+typedef UInt32  AudioSessionPropertyID;     //  AudioIO.h declares iOS audio session callbacks
+#endif
+#endif
+#include "Synthesizer.h"
+
+//  ---------------------------------------------------------------------------
+//      HostTimeToNanoSec
+//  ---------------------------------------------------------------------------
+static double
+HostTimeToNanoSec(uint64_t hostTime)
+{
+    static mach_timebase_info_data_t    timeInfo = { 0, 0 };
+    if (timeInfo.denom == 0)
+    {
+        ::mach_timebase_info(&timeInfo);
+    }
+    return static_cast<double>(hostTime) * timeInfo.numer / timeInfo.denom;
+}
+
+//  ---------------------------------------------------------------------------
+//      CallbackCost
+//  ---------------------------------------------------------------------------
+//  ns per callback, rendering the running sequence in blockLength callbacks (best of 3 runs)
+static double
+CallbackCost(Synthesizer& synth, int blockLength, int totalFrames)
+{
+    std::vector<int16_t>    data(blockLength * 2);
+    int16_t*    buffer[] = { &data[0], &data[blockLength] };
+    const int   numOfCallbacks = totalFrames / blockLength;
+    double  best = 0.0;
+    for (int run = 0; run < 3; ++run)
+    {
+        const uint64_t  start = ::mach_absolute_time();
+        for (int count = 0; count < numOfCallbacks; ++count)
+        {
+            synth.ProcessReplacing(NULL, buffer, blockLength);
+        }
+        const double    cost = HostTimeToNanoSec(::mach_absolute_time() - start) / numOfCallbacks;
+        best = ((run == 0) || (cost < best)) ? cost : best;
+    }
+    return best;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    const float fs = 44100.0f;
+    const int   totalFrames = static_cast<int>(fs * 20);
+    const int   blockLengths[] = { 16, 32, 48, 64, 128, 256, 512, 1024 };
+    const int   numOfBlockLengths = sizeof(blockLengths) / sizeof(blockLengths[0]);
+
+    Synthesizer synth(fs);
+    synth.StartSequence(0/* now */, 120.0f);
+    CallbackCost(synth, 256, totalFrames / 4);  //  warm up
+
+    double  cost[numOfBlockLengths];
+    double  sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    ::printf("block   ns/callback   ns/frame   callbacks/s   cpu %%\n");
+    for (int index = 0; index < numOfBlockLengths; ++index)
+    {
+        const int   blockLength = blockLengths[index];
+        cost[index] = CallbackCost(synth, blockLength, totalFrames);
+        const double    callbacksPerSec = fs / blockLength;
+        ::printf("%5d   %11.0f   %8.2f   %11.0f   %5.2f\n", blockLength, cost[index], cost[index] / blockLength,
+                 callbacksPerSec, cost[index] * callbacksPerSec / 10000000.0);
+        sumX += blockLength;
+        sumY += cost[index];
+        sumXX += static_cast<double>(blockLength) * blockLength;
+        sumXY += blockLength * cost[index];
+    }
+    const double    perFrame = (numOfBlockLengths * sumXY - sumX * sumY) / (numOfBlockLengths * sumXX - sumX * sumX);
+    const double    fixed = (sumY - perFrame * sumX) / numOfBlockLengths;
+    ::printf("fit : %.0f ns fixed per callback + %.2f ns per frame\n", fixed, perFrame);
+    return 0;
+}
@@ -0,0 +1,55 @@
+//
+//  AlignedBuffer.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+//
+//  fixed size, zero-initialized buffer aligned for SimdFloat4 access
+//
+template <typename T>
+class AlignedBuffer
+{
+public:
+    AlignedBuffer(size_t size) : data_(NULL), size_(size)
+    {
+        void*   ptr = NULL;
+        if (::posix_memalign(&ptr, kAlignment, ((size > 0) ? size : 1) * sizeof(T)) == 0)
+        {
+            data_ = static_cast<T*>(ptr);
+            this->Clear();
+        }
+        else
+        {
+            size_ = 0;
+        }
+    }
+    ~AlignedBuffer(void)    { ::free(data_); }
+
+    T*      Get(void)               { return data_; }
+    const T*    Get(void) const     { return data_; }
+    size_t  GetSize(void) const     { return size_; }
+    void    Clear(void)             { ::memset(data_, 0, size_ * sizeof(T)); }
+
+    T&      operator[] (size_t index)               { return data_[index]; }
+    const T&    operator[] (size_t index) const     { return data_[index]; }
+
+private:
+    AlignedBuffer(const AlignedBuffer& other);                      //  not implemented
+    const AlignedBuffer& operator= (const AlignedBuffer& other);    //  not implemented
+
+    enum
+    {
+        kAlignment = 16,
+    };
+
+    T*      data_;
+    size_t  size_;
+};
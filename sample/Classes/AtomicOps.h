@@ -0,0 +1,173 @@
+//
+//  AtomicOps.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#if defined(__APPLE__)
+#include <libkern/OSAtomic.h>
+#endif
+
+//
+//  thin wrappers of the lock-free primitives used between the audio thread and the others
+//
+
+//  ---------------------------------------------------------------------------
+//      AtomicMemoryBarrier
+//  ---------------------------------------------------------------------------
+static inline void
+AtomicMemoryBarrier(void)
+{
+#if defined(__APPLE__)
+    ::OSMemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicCompareAndSwapPtr
+//  ---------------------------------------------------------------------------
+static inline bool
+AtomicCompareAndSwapPtr(void* oldValue, void* newValue, void* volatile* target)
+{
+#if defined(__APPLE__)
+    return ::OSAtomicCompareAndSwapPtrBarrier(oldValue, newValue, target);
+#else
+    return __sync_bool_compare_and_swap(target, oldValue, newValue);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicCompareAndSwap32
+//  ---------------------------------------------------------------------------
+static inline bool
+AtomicCompareAndSwap32(int32_t oldValue, int32_t newValue, volatile int32_t* target)
+{
+#if defined(__APPLE__)
+    return ::OSAtomicCompareAndSwap32Barrier(oldValue, newValue, target);
+#else
+    return __sync_bool_compare_and_swap(target, oldValue, newValue);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicCompareAndSwap64
+//  ---------------------------------------------------------------------------
+static inline bool
+AtomicCompareAndSwap64(int64_t oldValue, int64_t newValue, volatile int64_t* target)
+{
+#if defined(__APPLE__)
+    return ::OSAtomicCompareAndSwap64Barrier(oldValue, newValue, target);
+#else
+    return __sync_bool_compare_and_swap(target, oldValue, newValue);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicLoad32
+//  ---------------------------------------------------------------------------
+static inline int32_t
+AtomicLoad32(volatile int32_t* target)
+{
+    const int32_t   value = *target;
+    AtomicMemoryBarrier();
+    return value;
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicStore32
+//  ---------------------------------------------------------------------------
+static inline void
+AtomicStore32(volatile int32_t* target, int32_t value)
+{
+    AtomicMemoryBarrier();
+    *target = value;
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicLoad64
+//  ---------------------------------------------------------------------------
+//  a plain 64-bit load may tear on 32-bit ARM; a successful CAS of the value with itself can not
+static inline int64_t
+AtomicLoad64(volatile int64_t* target)
+{
+    while (true)
+    {
+        const int64_t   value = *target;
+        if (AtomicCompareAndSwap64(value, value, target))
+        {
+            return value;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicExchange64
+//  ---------------------------------------------------------------------------
+static inline int64_t
+AtomicExchange64(volatile int64_t* target, int64_t value)
+{
+    while (true)
+    {
+        const int64_t   prev = *target;
+        if (AtomicCompareAndSwap64(prev, value, target))
+        {
+            return prev;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicStore64
+//  ---------------------------------------------------------------------------
+static inline void
+AtomicStore64(volatile int64_t* target, int64_t value)
+{
+    AtomicExchange64(target, value);
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicLoadPtr
+//  ---------------------------------------------------------------------------
+template <typename T>
+static inline T*
+AtomicLoadPtr(T* volatile* target)
+{
+    T*  value = *target;
+    AtomicMemoryBarrier();
+    return value;
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicStorePtr
+//  ---------------------------------------------------------------------------
+template <typename T>
+static inline void
+AtomicStorePtr(T* volatile* target, T* value)
+{
+    AtomicMemoryBarrier();
+    *target = value;
+}
+
+//  ---------------------------------------------------------------------------
+//      AtomicExchangePtr
+//  ---------------------------------------------------------------------------
+template <typename T>
+static inline T*
+AtomicExchangePtr(T* volatile* target, T* value)
+{
+    while (true)
+    {
+        T*  prev = *target;
+        if (AtomicCompareAndSwapPtr(prev, value, reinterpret_cast<void* volatile*>(target)))
+        {
+            return prev;
+        }
+    }
+}
@@ -0,0 +1,667 @@
+//
+//  AudioGraph.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <mach/mach.h>
+#include <string.h>
+#include <algorithm>
+#include "AudioGraph.h"
+#include "AtomicOps.h"
+#include "ScopedLock.h"
+
+//
+//  compiled, immutable form of the graph
+//
+class AudioGraph::Schedule
+{
+public:
+    typedef struct {
+        AudioIOListener*    listener;
+        int     outputBuffer;
+        int     firstInput;     //  index in inputBuffers
+        int     numberOfInputs;
+    } Step;
+
+    Schedule(void) : steps(), inputBuffers(), outputBuffers(), levelEnds(), data(), channels()  {}
+
+    int16_t**   GetBuffer(int bufferNo) const   { return const_cast<int16_t**>(&channels[bufferNo * 2]); }
+
+    std::vector<Step>   steps;          //  in execution order
+    std::vector<int>    inputBuffers;
+    std::vector<int>    outputBuffers;  //  summed into the AudioIO buffer
+    std::vector<int>    levelEnds;      //  steps of a level do not depend on each other
+    std::vector<int16_t>    data;
+    std::vector<int16_t*>   channels;
+};
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::AudioGraph
+//  ---------------------------------------------------------------------------
+AudioGraph::AudioGraph(int maxFrames, bool parallel) :
+maxFrames_(maxFrames),
+parallel_(parallel),
+nodes_(),
+editMutex_(),
+pending_(NULL),
+current_(NULL),
+retired_(NULL),
+helperThread_(),
+helperRunning_(false),
+helperWake_(),
+helperFinished_(),
+helperQuit_(false),
+helperClaim_(0),
+helperStepsDone_(0),
+helperWaiting_(0),
+helperGeneration_(0),
+helperSched_(NULL),
+helperIo_(NULL),
+helperEnd_(0),
+helperLength_(0)
+{
+    if (parallel_)
+    {
+        this->StartHelper();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::~AudioGraph
+//  ---------------------------------------------------------------------------
+AudioGraph::~AudioGraph(void)
+{
+    this->StopHelper();
+    this->Collect();
+    delete AtomicExchangePtr(&pending_, static_cast<Schedule*>(NULL));
+    delete current_;
+    current_ = NULL;
+}
+
+#pragma mark - edit
+//  ---------------------------------------------------------------------------
+//      AudioGraph::IsValidNode
+//  ---------------------------------------------------------------------------
+bool
+AudioGraph::IsValidNode(int nodeId) const
+{
+    return (nodeId >= 0) && (nodeId < static_cast<int>(nodes_.size())) && nodes_[nodeId].isValid;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::AddNode
+//  ---------------------------------------------------------------------------
+int
+AudioGraph::AddNode(AudioIOListener* listener)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    if (listener == NULL)
+    {
+        return kInvalidNode;
+    }
+    NodeDesc    node;
+    node.listener = listener;
+    node.isOutput = false;
+    node.isValid = true;
+    nodes_.push_back(node);
+    return static_cast<int>(nodes_.size()) - 1;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::RemoveNode
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::RemoveNode(int nodeId)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    if (this->IsValidNode(nodeId))
+    {
+        for (size_t nodeNo = 0; nodeNo < nodes_.size(); ++nodeNo)
+        {
+            std::vector<int>&   inputs = nodes_[nodeNo].inputs;
+            inputs.erase(std::remove(inputs.begin(), inputs.end(), nodeId), inputs.end());
+        }
+        NodeDesc&   node = nodes_[nodeId];
+        node.listener = NULL;
+        node.inputs.clear();
+        node.isOutput = false;
+        node.isValid = false;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::Connect
+//  ---------------------------------------------------------------------------
+bool
+AudioGraph::Connect(int srcNodeId, int destNodeId)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    if (!this->IsValidNode(srcNodeId) || !this->IsValidNode(destNodeId) || (srcNodeId == destNodeId))
+    {
+        return false;
+    }
+    std::vector<int>&   inputs = nodes_[destNodeId].inputs;
+    if (std::find(inputs.begin(), inputs.end(), srcNodeId) == inputs.end())
+    {
+        inputs.push_back(srcNodeId);
+    }
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::Disconnect
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::Disconnect(int srcNodeId, int destNodeId)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    if (this->IsValidNode(destNodeId))
+    {
+        std::vector<int>&   inputs = nodes_[destNodeId].inputs;
+        inputs.erase(std::remove(inputs.begin(), inputs.end(), srcNodeId), inputs.end());
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::SetOutput
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::SetOutput(int nodeId, bool isOutput)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    if (this->IsValidNode(nodeId))
+    {
+        nodes_[nodeId].isOutput = isOutput;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::Compile
+//  ---------------------------------------------------------------------------
+AudioGraph::Schedule*
+AudioGraph::Compile(void) const
+{
+    const int   numOfNodes = static_cast<int>(nodes_.size());
+
+    //  topological levels (Kahn) : level = 1 + deepest input
+    std::vector<int>    level(numOfNodes, -1);
+    std::vector<int>    pendingInputs(numOfNodes, 0);
+    std::vector< std::vector<int> > consumers(numOfNodes);
+    std::vector<int>    ready;
+    for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+    {
+        if (nodes_[nodeNo].isValid)
+        {
+            const std::vector<int>& inputs = nodes_[nodeNo].inputs;
+            pendingInputs[nodeNo] = static_cast<int>(inputs.size());
+            for (size_t inNo = 0; inNo < inputs.size(); ++inNo)
+            {
+                consumers[inputs[inNo]].push_back(nodeNo);
+            }
+            if (inputs.empty())
+            {
+                level[nodeNo] = 0;
+                ready.push_back(nodeNo);
+            }
+        }
+    }
+    std::vector<int>    order;
+    for (size_t readyNo = 0; readyNo < ready.size(); ++readyNo)
+    {
+        const int   nodeNo = ready[readyNo];
+        order.push_back(nodeNo);
+        for (size_t conNo = 0; conNo < consumers[nodeNo].size(); ++conNo)
+        {
+            const int   consumer = consumers[nodeNo][conNo];
+            level[consumer] = std::max(level[consumer], level[nodeNo] + 1);
+            if (--pendingInputs[consumer] == 0)
+            {
+                ready.push_back(consumer);
+            }
+        }
+    }
+    int numOfValidNodes = 0;
+    for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+    {
+        numOfValidNodes += nodes_[nodeNo].isValid ? 1 : 0;
+    }
+    if (static_cast<int>(order.size()) != numOfValidNodes)
+    {
+        return NULL;    //  cycle
+    }
+
+    //  execution order : by level, then by node id
+    int numOfLevels = 0;
+    std::vector< std::vector<int> > levels;
+    for (size_t orderNo = 0; orderNo < order.size(); ++orderNo)
+    {
+        numOfLevels = std::max(numOfLevels, level[order[orderNo]] + 1);
+    }
+    levels.resize(numOfLevels);
+    for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+    {
+        if (nodes_[nodeNo].isValid)
+        {
+            levels[level[nodeNo]].push_back(nodeNo);
+        }
+    }
+
+    //  liveness : a buffer is free again after the level of its last reader.
+    //  outputs are read by the final mix, after every level.
+    std::vector<int>    lastUse(numOfNodes, -1);
+    for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+    {
+        if (nodes_[nodeNo].isValid)
+        {
+            lastUse[nodeNo] = nodes_[nodeNo].isOutput ? numOfLevels : level[nodeNo];
+            for (size_t conNo = 0; conNo < consumers[nodeNo].size(); ++conNo)
+            {
+                lastUse[nodeNo] = std::max(lastUse[nodeNo], level[consumers[nodeNo][conNo]]);
+            }
+        }
+    }
+
+    Schedule*   sched = new Schedule();
+    std::vector<int>    bufferOfNode(numOfNodes, -1);
+    std::vector<int>    freeBuffers;
+    int numOfBuffers = 0;
+    for (int levelNo = 0; levelNo < numOfLevels; ++levelNo)
+    {
+        const std::vector<int>& nodesInLevel = levels[levelNo];
+        for (size_t index = 0; index < nodesInLevel.size(); ++index)
+        {
+            const int   nodeNo = nodesInLevel[index];
+            int bufferNo = numOfBuffers;
+            if (!freeBuffers.empty())
+            {
+                bufferNo = freeBuffers.back();
+                freeBuffers.pop_back();
+            }
+            else
+            {
+                ++numOfBuffers;
+            }
+            bufferOfNode[nodeNo] = bufferNo;
+
+            const std::vector<int>& inputs = nodes_[nodeNo].inputs;
+            Schedule::Step  step;
+            step.listener = nodes_[nodeNo].listener;
+            step.outputBuffer = bufferNo;
+            step.firstInput = static_cast<int>(sched->inputBuffers.size());
+            step.numberOfInputs = static_cast<int>(inputs.size());
+            for (size_t inNo = 0; inNo < inputs.size(); ++inNo)
+            {
+                sched->inputBuffers.push_back(bufferOfNode[inputs[inNo]]);
+            }
+            sched->steps.push_back(step);
+        }
+        sched->levelEnds.push_back(static_cast<int>(sched->steps.size()));
+
+        for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+        {
+            if ((lastUse[nodeNo] == levelNo) && (bufferOfNode[nodeNo] >= 0))
+            {
+                freeBuffers.push_back(bufferOfNode[nodeNo]);
+            }
+        }
+    }
+    for (int nodeNo = 0; nodeNo < numOfNodes; ++nodeNo)
+    {
+        if (nodes_[nodeNo].isValid && nodes_[nodeNo].isOutput)
+        {
+            sched->outputBuffers.push_back(bufferOfNode[nodeNo]);
+        }
+    }
+
+    sched->data.assign(numOfBuffers * 2 * maxFrames_, 0);
+    for (int ch = 0; ch < numOfBuffers * 2; ++ch)
+    {
+        sched->channels.push_back(&sched->data[ch * maxFrames_]);
+    }
+    return sched;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::Commit
+//  ---------------------------------------------------------------------------
+bool
+AudioGraph::Commit(void)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    Schedule*   sched = this->Compile();
+    if (sched == NULL)
+    {
+        return false;
+    }
+    this->Collect();
+    delete AtomicExchangePtr(&pending_, sched);     //  never seen by the audio thread
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::Collect
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::Collect(void)
+{
+    Schedule*   sched = AtomicLoadPtr(&retired_);
+    if (sched != NULL)
+    {
+        delete sched;
+        AtomicStorePtr(&retired_, static_cast<Schedule*>(NULL));
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::IsSettled
+//  ---------------------------------------------------------------------------
+bool
+AudioGraph::IsSettled(void) const
+{
+    return (pending_ == NULL) && (retired_ == NULL);
+}
+
+#pragma mark - render
+//  ---------------------------------------------------------------------------
+//      AudioGraph::UpdateSchedule
+//  ---------------------------------------------------------------------------
+inline void
+AudioGraph::UpdateSchedule(void)
+{
+    //  the previous schedule can only be released when the last one was collected
+    if (AtomicLoadPtr(&retired_) == NULL)
+    {
+        Schedule*   sched = AtomicLoadPtr(&pending_);
+        if ((sched != NULL) && AtomicCompareAndSwapPtr(sched, NULL, reinterpret_cast<void* volatile*>(&pending_)))
+        {
+            if (current_ != NULL)
+            {
+                AtomicStorePtr(&retired_, current_);
+            }
+            current_ = sched;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      MixSaturated
+//  ---------------------------------------------------------------------------
+static inline void
+MixSaturated(int16_t* dest, const int16_t* src, int length)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    for (int i = 0; i < length; ++i)
+    {
+        const int32_t   mixed = static_cast<int32_t>(dest[i]) + src[i];
+        dest[i] = CLIP(mixed, -0x7FFF, 0x7FFF);
+    }
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::ProcessStep
+//  ---------------------------------------------------------------------------
+inline void
+AudioGraph::ProcessStep(const Schedule* sched, int stepNo, AudioIO* io, int length)
+{
+    const Schedule::Step&   step = sched->steps[stepNo];
+    int16_t**   output = sched->GetBuffer(step.outputBuffer);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        if (step.numberOfInputs == 0)
+        {
+            ::memset(output[ch], 0, length * sizeof(int16_t));
+        }
+        else
+        {
+            ::memcpy(output[ch], sched->GetBuffer(sched->inputBuffers[step.firstInput])[ch], length * sizeof(int16_t));
+            for (int inNo = 1; inNo < step.numberOfInputs; ++inNo)
+            {
+                MixSaturated(output[ch], sched->GetBuffer(sched->inputBuffers[step.firstInput + inNo])[ch], length);
+            }
+        }
+    }
+    step.listener->ProcessReplacing(io, output, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::ClaimStep
+//  ---------------------------------------------------------------------------
+//  returns the step to process next, or -1 when the level of generation is exhausted
+inline int
+AudioGraph::ClaimStep(int32_t generation, int end)
+{
+    while (true)
+    {
+        const int32_t   claim = helperClaim_;
+        const int       stepNo = claim & 0xFFFF;
+        if (((claim >> 16) != generation) || (stepNo >= end))
+        {
+            return -1;
+        }
+        if (AtomicCompareAndSwap32(claim, claim + 1, &helperClaim_))
+        {
+            return stepNo;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::FinishStep
+//  ---------------------------------------------------------------------------
+inline void
+AudioGraph::FinishStep(void)
+{
+    while (true)
+    {
+        const int32_t   done = helperStepsDone_;
+        if (AtomicCompareAndSwap32(done, done + 1, &helperStepsDone_))
+        {
+            return;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::ProcessLevel
+//  ---------------------------------------------------------------------------
+inline void
+AudioGraph::ProcessLevel(const Schedule* sched, int begin, int end, AudioIO* io, int length)
+{
+    if (helperRunning_ && (end - begin > 1))
+    {
+        //  the parameters are stable while the level has unclaimed steps
+        const int32_t   generation = (helperGeneration_ + 1) & 0x7FFF;
+        helperGeneration_ = generation;
+        helperSched_ = sched;
+        helperIo_ = io;
+        helperEnd_ = end;
+        helperLength_ = length;
+        helperStepsDone_ = 0;
+        AtomicStore32(&helperClaim_, (generation << 16) | begin);
+        ::semaphore_signal(helperWake_);
+
+        //  everything the helper has not claimed yet is processed here
+        int stepNo;
+        while ((stepNo = this->ClaimStep(generation, end)) >= 0)
+        {
+            this->ProcessStep(sched, stepNo, io, length);
+            this->FinishStep();
+        }
+
+        //  only a step in progress on the helper is left : spin a little, then sleep
+        static const int    kSpinLimit = 1000;
+        const int32_t   numOfSteps = end - begin;
+        int spin = 0;
+        while (AtomicLoad32(&helperStepsDone_) < numOfSteps)
+        {
+            if (++spin > kSpinLimit)
+            {
+                AtomicStore32(&helperWaiting_, 1);
+                if (AtomicLoad32(&helperStepsDone_) < numOfSteps)
+                {
+                    const mach_timespec_t   timeout = { 0, 100000 };
+                    ::semaphore_timedwait(helperFinished_, timeout);
+                }
+                AtomicCompareAndSwap32(1, 0, &helperWaiting_);
+            }
+        }
+    }
+    else
+    {
+        for (int stepNo = begin; stepNo < end; ++stepNo)
+        {
+            this->ProcessStep(sched, stepNo, io, length);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::ProcessSchedule
+//  ---------------------------------------------------------------------------
+inline void
+AudioGraph::ProcessSchedule(const Schedule* sched, AudioIO* io, int16_t** buffer, int length)
+{
+    int begin = 0;
+    for (size_t levelNo = 0; levelNo < sched->levelEnds.size(); ++levelNo)
+    {
+        const int   end = sched->levelEnds[levelNo];
+        this->ProcessLevel(sched, begin, end, io, length);
+        begin = end;
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        ::memset(buffer[ch], 0, length * sizeof(int16_t));
+        for (size_t outNo = 0; outNo < sched->outputBuffers.size(); ++outNo)
+        {
+            MixSaturated(buffer[ch], sched->GetBuffer(sched->outputBuffers[outNo])[ch], length);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::ProcessReplacing
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::ProcessReplacing(AudioIO* io, int16_t** buffer, int length)
+{
+    this->UpdateSchedule();
+
+    const Schedule* sched = current_;
+    if (sched == NULL)
+    {
+        ::memset(buffer[0], 0, length * sizeof(int16_t));
+        ::memset(buffer[1], 0, length * sizeof(int16_t));
+        return;
+    }
+
+    int rest = length;
+    int offset = 0;
+    while (rest > 0)
+    {
+        const int   frames = std::min(rest, maxFrames_);
+        int16_t*    output[] = { buffer[0] + offset, buffer[1] + offset };
+        this->ProcessSchedule(sched, io, output, frames);
+        offset += frames;
+        rest -= frames;
+    }
+}
+
+#pragma mark - helper thread
+//  ---------------------------------------------------------------------------
+//      AudioGraph::StartHelper
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::StartHelper(void)
+{
+    if (::semaphore_create(::mach_task_self(), &helperWake_, SYNC_POLICY_FIFO, 0) != KERN_SUCCESS)
+    {
+        return;
+    }
+    if (::semaphore_create(::mach_task_self(), &helperFinished_, SYNC_POLICY_FIFO, 0) != KERN_SUCCESS)
+    {
+        ::semaphore_destroy(::mach_task_self(), helperWake_);
+        return;
+    }
+    helperQuit_ = false;
+
+    pthread_attr_t  attr;
+    ::pthread_attr_init(&attr);
+    ::pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    struct sched_param  param;
+    param.sched_priority = ::sched_get_priority_max(SCHED_FIFO);
+    ::pthread_attr_setschedparam(&attr, &param);
+    helperRunning_ = (::pthread_create(&helperThread_, &attr, AudioGraph::HelperThreadEntry, this) == 0);
+    ::pthread_attr_destroy(&attr);
+    if (!helperRunning_)
+    {
+        ::semaphore_destroy(::mach_task_self(), helperWake_);
+        ::semaphore_destroy(::mach_task_self(), helperFinished_);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::StopHelper
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::StopHelper(void)
+{
+    if (helperRunning_)
+    {
+        helperRunning_ = false;
+        helperQuit_ = true;
+        AtomicMemoryBarrier();
+        ::semaphore_signal(helperWake_);
+        ::pthread_join(helperThread_, NULL);
+        ::semaphore_destroy(::mach_task_self(), helperWake_);
+        ::semaphore_destroy(::mach_task_self(), helperFinished_);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::RunHelper
+//  ---------------------------------------------------------------------------
+void
+AudioGraph::RunHelper(void)
+{
+    while (true)
+    {
+        ::semaphore_wait(helperWake_);
+        AtomicMemoryBarrier();
+        if (helperQuit_)
+        {
+            break;
+        }
+        //  a wake-up for a level the audio thread has already finished claims nothing
+        const int32_t   generation = AtomicLoad32(&helperClaim_) >> 16;
+        const Schedule* sched = helperSched_;
+        AudioIO*    io = helperIo_;
+        const int   end = helperEnd_;
+        const int   length = helperLength_;
+        int stepNo;
+        while ((stepNo = this->ClaimStep(generation, end)) >= 0)
+        {
+            this->ProcessStep(sched, stepNo, io, length);
+            this->FinishStep();
+            if (AtomicCompareAndSwap32(1, 0, &helperWaiting_))
+            {
+                ::semaphore_signal(helperFinished_);
+            }
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioGraph::HelperThreadEntry                               [static]
+//  ---------------------------------------------------------------------------
+void*
+AudioGraph::HelperThreadEntry(void* arg)
+{
+    AudioGraph* graph = reinterpret_cast<AudioGraph*>(arg);
+    graph->RunHelper();
+    return NULL;
+}
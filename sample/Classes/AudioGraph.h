@@ -0,0 +1,105 @@
+//
+//  AudioGraph.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <vector>
+#include <pthread.h>
+#include <mach/semaphore.h>
+#include "AudioIO.h"
+#include "CriticalSection.h"
+
+//
+//  In-process processing graph hosted by AudioIO as a single listener.
+//
+//  Every node is an AudioIOListener. On entry to ProcessReplacing the buffer holds the
+//  (saturated) sum of the outputs of the node's inputs, or silence for a source node,
+//  and the node replaces it with its own output. The outputs of the nodes marked as
+//  output are summed into the AudioIO buffer.
+//
+//  Edit the graph and call Commit() off the audio thread; the compiled schedule
+//  (execution order, edge buffers) is swapped in atomically at the next callback.
+//  A listener must stay alive until a schedule without it has been committed and
+//  the previous one has been collected (IsSettled()).
+//
+class AudioGraph : public AudioIOListener
+{
+public:
+    enum
+    {
+        kInvalidNode = -1,
+    };
+
+    AudioGraph(int maxFrames, bool parallel = false);
+    ~AudioGraph(void);
+
+    //  edit (non real-time thread)
+    int     AddNode(AudioIOListener* listener);
+    void    RemoveNode(int nodeId);
+    bool    Connect(int srcNodeId, int destNodeId);
+    void    Disconnect(int srcNodeId, int destNodeId);
+    void    SetOutput(int nodeId, bool isOutput);
+    bool    Commit(void);
+    void    Collect(void);
+    bool    IsSettled(void) const;
+
+    //  AudioIOListener
+    void    ProcessReplacing(AudioIO* io, int16_t** buffer, int length);
+
+private:
+    AudioGraph(const AudioGraph& other);                        //  not implemented
+    const AudioGraph& operator= (const AudioGraph& other);      //  not implemented
+
+    typedef struct {
+        AudioIOListener*    listener;
+        std::vector<int>    inputs;
+        bool                isOutput;
+        bool                isValid;
+    } NodeDesc;
+
+    class Schedule;
+
+    bool    IsValidNode(int nodeId) const;
+    Schedule*   Compile(void) const;
+    void    UpdateSchedule(void);
+    void    ProcessStep(const Schedule* sched, int stepNo, AudioIO* io, int length);
+    int     ClaimStep(int32_t generation, int end);
+    void    FinishStep(void);
+    void    ProcessLevel(const Schedule* sched, int begin, int end, AudioIO* io, int length);
+    void    ProcessSchedule(const Schedule* sched, AudioIO* io, int16_t** buffer, int length);
+
+    void    StartHelper(void);
+    void    StopHelper(void);
+    void    RunHelper(void);
+    static void*    HelperThreadEntry(void* arg);
+
+    const int   maxFrames_;
+    const bool  parallel_;
+    std::vector<NodeDesc>   nodes_;
+    CriticalSection     editMutex_;
+    Schedule* volatile  pending_;   //  committed, not yet picked up by the audio thread
+    Schedule*           current_;   //  owned by the audio thread
+    Schedule* volatile  retired_;   //  released by the audio thread, deleted by Collect()
+
+    //  parallel branch helper : the steps of a level are claimed one by one by
+    //  either thread, so a helper that is late or preempted never holds up the
+    //  steps it has not started
+    pthread_t       helperThread_;
+    bool            helperRunning_;
+    semaphore_t     helperWake_;
+    semaphore_t     helperFinished_;
+    volatile bool   helperQuit_;
+    volatile int32_t    helperClaim_;       //  generation << 16 | next step
+    volatile int32_t    helperStepsDone_;
+    volatile int32_t    helperWaiting_;     //  the audio thread sleeps on helperFinished_
+    int32_t         helperGeneration_;      //  owned by the audio thread
+    const Schedule* helperSched_;
+    AudioIO*        helperIo_;
+    int             helperEnd_;
+    int             helperLength_;
+};
@@ -10,6 +10,7 @@
 
 #include <AudioToolbox/AudioToolbox.h>
 #include <vector>
+#include "AtomicOps.h"
 
 class AudioIOListener
 {
@@ -31,10 +32,16 @@ public:
 
     bool    IsRunning(void) const;
 
-    uint64_t    GetHostTime(void) const     { return hostTime_; }
-    uint64_t    GetLatency(void) const      { return latency_; }
+    //  any thread
+    uint64_t    GetHostTime(void) const     { return static_cast<uint64_t>(AtomicLoad64(&hostTime_)); }
+    uint64_t    GetLatency(void) const      { return static_cast<uint64_t>(AtomicLoad64(&latency_)); }
 
     void    SetListener(AudioIOListener* listener);
+
+    //  request a 32 - 64 frame hardware buffer instead of the default 1024 frames
+    void    SetLowLatencyMode(bool enable, uint32_t frames = 64);
+    bool    IsLowLatencyMode(void) const    { return isLowLatencyMode_; }
+    uint32_t    GetIOBufferSize(void) const { return ioBufferSize_; }
     
     Float32 GetCPULoad(void) const;
     Float32 GetMaxCPULoad(void) const;
@@ -61,11 +68,14 @@ private:
     const uint32_t  numberOfOutputBus_;
     const Float32   sampleRate_;
     uint32_t        ioBufferSize_;
+    bool            isLowLatencyMode_;
     AudioUnit       remoteIOUnit_;
     AUGraph         auGraph_;
     bool            isRunning_;
     std::vector<int16_t>    dataBuffer_;
     std::vector<int16_t*>   outputBuffer_;
-    uint64_t    hostTime_;
-    uint64_t    latency_;
+    mutable volatile int64_t    hostTime_;  //  written by the render thread
+    mutable volatile int64_t    latency_;   //  written by the control thread
+    uint32_t    timebaseNumer_;     //  mach_timebase_info, queried once
+    uint32_t    timebaseDenom_;
 };
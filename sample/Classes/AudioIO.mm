@@ -17,6 +17,13 @@
         }                               \
     } while (false)
 
+enum
+{
+    kDefaultIOBufferSize = 1024,
+    kMinLowLatencyIOBufferSize = 32,
+    kMaxLowLatencyIOBufferSize = 64,
+};
+
 //  ---------------------------------------------------------------------------
 //      AudioIO::AudioIO
 //  ---------------------------------------------------------------------------
@@ -25,15 +32,25 @@ listener_(NULL),
 bufferLength_(4096),
 numberOfOutputBus_(2),
 sampleRate_(samplingRate),
-ioBufferSize_(1024),   //  audio I/O buffer size
+ioBufferSize_(kDefaultIOBufferSize),   //  audio I/O buffer size
+isLowLatencyMode_(false),
 remoteIOUnit_(NULL),
 auGraph_(NULL),
 isRunning_(false),
 dataBuffer_(),
 outputBuffer_(),
 hostTime_(0),
-latency_(0)
+latency_(0),
+timebaseNumer_(1),
+timebaseDenom_(1)
 {
+    mach_timebase_info_data_t   timeInfo;
+    if (::mach_timebase_info(&timeInfo) == KERN_SUCCESS)
+    {
+        timebaseNumer_ = timeInfo.numer;
+        timebaseDenom_ = timeInfo.denom;
+    }
+
     dataBuffer_.assign(bufferLength_ * numberOfOutputBus_, 0);
     outputBuffer_.clear();
     for (uint32_t ch = 0; ch < numberOfOutputBus_; ++ch)
@@ -210,8 +227,9 @@ AudioIO::SetIOBufferSize(void)
         Float32 duration = static_cast<float>(ioBufferSize_) / sampleRate_;
         ThrowIfOSStatus_(::AudioSessionSetProperty(kAudioSessionProperty_PreferredHardwareIOBufferDuration, sizeof(duration), &duration));
         UInt32  size = sizeof(duration);
-        ThrowIfOSStatus_(::AudioSessionGetProperty(kAudioSessionProperty_PreferredHardwareIOBufferDuration, &size, &duration));
-        latency_ = static_cast<UInt64>(duration * 1000000000ULL);
+        //  the hardware may not grant the preferred duration
+        ThrowIfOSStatus_(::AudioSessionGetProperty(kAudioSessionProperty_CurrentHardwareIOBufferDuration, &size, &duration));
+        AtomicStore64(&latency_, static_cast<int64_t>(duration * 1000000000ULL));
     }
     catch(OSStatus& inErr)
     {
@@ -219,6 +237,20 @@ AudioIO::SetIOBufferSize(void)
     }
 }
 
+//  ---------------------------------------------------------------------------
+//      AudioIO::SetLowLatencyMode
+//  ---------------------------------------------------------------------------
+void
+AudioIO::SetLowLatencyMode(bool enable, uint32_t frames)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    isLowLatencyMode_ = enable;
+    ioBufferSize_ = enable ? CLIP(frames, static_cast<uint32_t>(kMinLowLatencyIOBufferSize), static_cast<uint32_t>(kMaxLowLatencyIOBufferSize))
+                           : static_cast<uint32_t>(kDefaultIOBufferSize);
+    this->SetIOBufferSize();
+#undef CLIP
+}
+
 #pragma mark - render callback
 //  ---------------------------------------------------------------------------
 //      ConvertSInt16ToAudioSampleType
@@ -236,14 +268,12 @@ void
 AudioIO::Render(AudioUnitRenderActionFlags* ioActionFlags, const AudioTimeStamp* inTimeStamp, UInt32 inBusNumber, UInt32 inNumberFrames,
                 AudioBufferList* ioData)
 {
+    uint64_t    hostTime = 0;
     if ((inTimeStamp != NULL) && ((inTimeStamp->mFlags & kAudioTimeStampHostTimeValid) != 0))
     {
-        hostTime_ = inTimeStamp->mHostTime;
-    }
-    else
-    {
-        hostTime_ = 0;
+        hostTime = inTimeStamp->mHostTime;
     }
+    AtomicStore64(&hostTime_, static_cast<int64_t>(hostTime));
 
     //  render
     if (listener_ != NULL)
@@ -266,12 +296,11 @@ AudioIO::Render(AudioUnitRenderActionFlags* ioActionFlags, const AudioTimeStamp*
             rest -= processLength;
             dataBufPtr += processLength * numberOfOutputBus_;
 
-            if (rest > 0)
+            if ((rest > 0) && (hostTime != 0))
             {
-                mach_timebase_info_data_t   timeInfo;
-                mach_timebase_info(&timeInfo);
                 const uint64_t  timeNano = static_cast<uint64_t>(static_cast<float>(processLength) * 1000000000ULL / sampleRate_);
-                hostTime_ += timeNano * timeInfo.denom / timeInfo.numer;
+                hostTime += timeNano * timebaseDenom_ / timebaseNumer_;
+                AtomicStore64(&hostTime_, static_cast<int64_t>(hostTime));
             }
         }
     }
@@ -284,10 +313,9 @@ OSStatus
 AudioIO::RenderCallback(void* inRefCon, AudioUnitRenderActionFlags* ioActionFlags, const AudioTimeStamp* inTimeStamp,
                         UInt32 inBusNumber, UInt32 inNumberFrames, AudioBufferList* ioData)
 {
-    NSAutoreleasePool*  pool = [[NSAutoreleasePool alloc] init];
+    //  no Objective-C objects are created on the render thread, so no autorelease pool
     AudioIO*  io = reinterpret_cast<AudioIO*>(inRefCon);
     io->Render(ioActionFlags, inTimeStamp, inBusNumber, inNumberFrames, ioData);
-    [pool release];
     return noErr;
 }
 
@@ -0,0 +1,116 @@
+//
+//  BlockFloatCodec.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+//
+//  Block floating point sample compression.
+//  Every block holds kBlockFloatFrames frames; each channel of a block is stored as 12-bit
+//  mantissas sharing one shift, so a block decodes independently of the others.
+//  Samples are in the signed 24-bit range (see SampleFormat.h).
+//
+enum
+{
+    kBlockFloatFrames = 64,
+    kBlockFloatHalfFrames = kBlockFloatFrames / 2,
+    kBlockFloatMantissaBits = 12,
+    kBlockFloatMaxMantissa = (1 << (kBlockFloatMantissaBits - 1)) - 1,
+    kBlockFloatMaxShift = 24 - kBlockFloatMantissaBits,    //  2047 << 12 covers the 24-bit range
+};
+
+//  mantissa bits 0-7 of frame n are low[n], bits 8-11 the low nibble of high[n] for the first
+//  half of the block and the high nibble of high[n - 32] for the second half : both halves
+//  decode with the same contiguous loads
+template <int Channels>
+struct BlockFloatBlock
+{
+    uint8_t low[Channels][kBlockFloatFrames];
+    uint8_t high[Channels][kBlockFloatHalfFrames];
+    uint8_t shift[Channels];
+};
+
+//  ---------------------------------------------------------------------------
+//      BlockFloatExpand
+//  ---------------------------------------------------------------------------
+//  12-bit mantissa bits -> sample
+static inline int32_t
+BlockFloatExpand(uint32_t bits, uint32_t shift)
+{
+    const int   signShift = 32 - kBlockFloatMantissaBits;
+    return static_cast<int32_t>(bits << signShift) >> (signShift - shift);
+}
+
+//  ---------------------------------------------------------------------------
+//      BlockFloatSample
+//  ---------------------------------------------------------------------------
+//  the decoded sample of one frame of a channel
+template <int Channels>
+static inline int32_t
+BlockFloatSample(const BlockFloatBlock<Channels>& block, int ch, uint32_t frame)
+{
+    const uint32_t  nibbles = block.high[ch][frame % kBlockFloatHalfFrames];
+    const uint32_t  high = (frame < kBlockFloatHalfFrames) ? (nibbles & 0x0F) : (nibbles >> 4);
+    return BlockFloatExpand(block.low[ch][frame] | (high << 8), block.shift[ch]);
+}
+
+//  ---------------------------------------------------------------------------
+//      BlockFloatEncode
+//  ---------------------------------------------------------------------------
+//  encode up to kBlockFloatFrames interleaved frames, the rest of the block is zero
+template <int Channels>
+static inline void
+BlockFloatEncode(const int32_t* src, uint32_t frames, BlockFloatBlock<Channels>& block)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    ::memset(&block, 0, sizeof(block));
+    for (int ch = 0; ch < Channels; ++ch)
+    {
+        int32_t maxAbs = 0;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            const int32_t   sample = src[frame * Channels + ch];
+            const int32_t   absSample = (sample < 0) ? -sample : sample;
+            maxAbs = (absSample > maxAbs) ? absSample : maxAbs;
+        }
+        uint32_t    shift = 0;
+        while (((maxAbs >> shift) > kBlockFloatMaxMantissa) && (shift < kBlockFloatMaxShift))
+        {
+            ++shift;
+        }
+        const int32_t   round = (shift > 0) ? (1 << (shift - 1)) : 0;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            const int32_t   mantissa = (src[frame * Channels + ch] + round) >> shift;
+            const uint32_t  bits = static_cast<uint32_t>(CLIP(mantissa, -kBlockFloatMaxMantissa, kBlockFloatMaxMantissa));
+            block.low[ch][frame] = static_cast<uint8_t>(bits);
+            const uint32_t  high = (bits >> 8) & 0x0F;
+            block.high[ch][frame % kBlockFloatHalfFrames] |= static_cast<uint8_t>((frame < kBlockFloatHalfFrames) ? high : (high << 4));
+        }
+        block.shift[ch] = static_cast<uint8_t>(shift);
+    }
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      BlockFloatDecode
+//  ---------------------------------------------------------------------------
+//  decode the kBlockFloatFrames mantissas of one channel. Both halves are contiguous
+//  loads with a uniform shift, so the compiler vectorizes the loop (NEON / SSE2).
+static inline void
+BlockFloatDecode(const uint8_t* low, const uint8_t* high, uint32_t shift, int32_t* dest)
+{
+    for (int i = 0; i < kBlockFloatHalfFrames; ++i)
+    {
+        const uint32_t  nibbles = high[i];
+        dest[i] = BlockFloatExpand(low[i] | ((nibbles & 0x0F) << 8), shift);
+        dest[i + kBlockFloatHalfFrames] = BlockFloatExpand(low[i + kBlockFloatHalfFrames] | ((nibbles >> 4) << 8), shift);
+    }
+}
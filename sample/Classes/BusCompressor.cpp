@@ -0,0 +1,201 @@
+//
+//  BusCompressor.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include <algorithm>
+#include "BusCompressor.h"
+#include "AtomicOps.h"
+#include "SimdTypes.h"
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::BusCompressor
+//  ---------------------------------------------------------------------------
+BusCompressor::BusCompressor(float samplingRate) :
+samplingRate_(samplingRate),
+envelope_(0.0f),
+thresholdLinear_(1.0f),
+slope_(0.0f),
+attackCoef_(1.0f),
+releaseCoef_(1.0f),
+makeupLinear_(1.0f),
+enabled_(false),
+threshold_(-12.0f),
+ratio_(4.0f),
+attack_(0.005f),
+release_(0.12f),
+makeup_(0.0f),
+paramsChanged_(1)
+{
+    this->UpdateCoefficients();
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::~BusCompressor
+//  ---------------------------------------------------------------------------
+BusCompressor::~BusCompressor(void)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetEnabled
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetEnabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetThreshold
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetThreshold(float dB)
+{
+    threshold_ = dB;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetRatio
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetRatio(float ratio)
+{
+    ratio_ = (ratio > 1.0f) ? ratio : 1.0f;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetAttack
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetAttack(float seconds)
+{
+    attack_ = seconds;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetRelease
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetRelease(float seconds)
+{
+    release_ = seconds;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::SetMakeupGain
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::SetMakeupGain(float dB)
+{
+    makeup_ = dB;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::UpdateCoefficients
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::UpdateCoefficients(void)
+{
+    //  the envelope steps once per kSimdWidth frames
+    const float stepRate = samplingRate_ / kSimdWidth;
+    const float attack = (attack_ > 0.0001f) ? attack_ : 0.0001f;
+    const float release = (release_ > 0.001f) ? release_ : 0.001f;
+    thresholdLinear_ = ::powf(10.0f, threshold_ / 20.0f);
+    slope_ = 1.0f - 1.0f / ratio_;
+    attackCoef_ = 1.0f - ::expf(-1.0f / (attack * stepRate));
+    releaseCoef_ = 1.0f - ::expf(-1.0f / (release * stepRate));
+    makeupLinear_ = ::powf(10.0f, makeup_ / 20.0f);
+}
+
+//  ---------------------------------------------------------------------------
+//      BusCompressor::Process
+//  ---------------------------------------------------------------------------
+void
+BusCompressor::Process(float* left, float* right, int length)
+{
+    if (!enabled_)
+    {
+        envelope_ = 0.0f;
+        return;
+    }
+    if (AtomicCompareAndSwap32(1, 0, &paramsChanged_))
+    {
+        this->UpdateCoefficients();
+    }
+
+    //  below the threshold with a settled envelope: only the make-up gain applies
+    const float peak = std::max(SimdPeak(left, length), SimdPeak(right, length));
+    if ((peak < thresholdLinear_) && (envelope_ < thresholdLinear_))
+    {
+        envelope_ *= ::powf(1.0f - releaseCoef_, static_cast<float>(length) / kSimdWidth);
+        if (makeupLinear_ != 1.0f)
+        {
+            const SimdFloat4    makeup = SimdSplat(makeupLinear_);
+            SimdFloat4* vecLeft = reinterpret_cast<SimdFloat4*>(left);
+            SimdFloat4* vecRight = reinterpret_cast<SimdFloat4*>(right);
+            for (int index = 0; index < length / kSimdWidth; ++index)
+            {
+                vecLeft[index] *= makeup;
+                vecRight[index] *= makeup;
+            }
+            for (int frame = (length / kSimdWidth) * kSimdWidth; frame < length; ++frame)
+            {
+                left[frame] *= makeupLinear_;
+                right[frame] *= makeupLinear_;
+            }
+        }
+        return;
+    }
+
+    float   envelope = envelope_;
+    SimdFloat4* vecLeft = reinterpret_cast<SimdFloat4*>(left);
+    SimdFloat4* vecRight = reinterpret_cast<SimdFloat4*>(right);
+    const int   numOfVectors = (length + kSimdWidth - 1) / kSimdWidth;
+    for (int index = 0; index < numOfVectors; ++index)
+    {
+        const int   frames = std::min<int>(length - index * kSimdWidth, kSimdWidth);
+        float   chunkPeak;
+        if (frames == kSimdWidth)
+        {
+            chunkPeak = SimdHorizontalMax(SimdMax(SimdAbs(vecLeft[index]), SimdAbs(vecRight[index])));
+        }
+        else
+        {
+            chunkPeak = SimdPeak(left + index * kSimdWidth, frames);
+            chunkPeak = std::max(chunkPeak, SimdPeak(right + index * kSimdWidth, frames));
+        }
+        envelope += ((chunkPeak > envelope) ? attackCoef_ : releaseCoef_) * (chunkPeak - envelope);
+
+        float   gain = makeupLinear_;
+        if (envelope > thresholdLinear_)
+        {
+            //  (threshold / envelope) ^ (1 - 1 / ratio)
+            gain *= ::powf(thresholdLinear_ / envelope, slope_);
+        }
+        if (frames == kSimdWidth)
+        {
+            const SimdFloat4    gainVec = SimdSplat(gain);
+            vecLeft[index] *= gainVec;
+            vecRight[index] *= gainVec;
+        }
+        else
+        {
+            for (int frame = index * kSimdWidth; frame < length; ++frame)
+            {
+                left[frame] *= gain;
+                right[frame] *= gain;
+            }
+        }
+    }
+    envelope_ = envelope;
+}
@@ -0,0 +1,56 @@
+//
+//  BusCompressor.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+//
+//  stereo-linked peak compressor for the master bus.
+//  The detector and the gain run once per kSimdWidth frames.
+//
+class BusCompressor
+{
+public:
+    BusCompressor(float samplingRate);
+    ~BusCompressor(void);
+
+    //  any thread; applied at the next Process()
+    void    SetEnabled(bool enabled);
+    void    SetThreshold(float dB);
+    void    SetRatio(float ratio);
+    void    SetAttack(float seconds);
+    void    SetRelease(float seconds);
+    void    SetMakeupGain(float dB);
+
+    //  audio thread, in place. The buffers must be 16-byte aligned.
+    void    Process(float* left, float* right, int length);
+
+private:
+    BusCompressor(const BusCompressor& other);                      //  not implemented
+    const BusCompressor& operator= (const BusCompressor& other);    //  not implemented
+
+    void    UpdateCoefficients(void);
+
+    const float samplingRate_;
+    float   envelope_;
+    float   thresholdLinear_;
+    float   slope_;
+    float   attackCoef_;
+    float   releaseCoef_;
+    float   makeupLinear_;
+
+    //  parameters, written by the control thread
+    volatile bool   enabled_;
+    volatile float  threshold_;
+    volatile float  ratio_;
+    volatile float  attack_;
+    volatile float  release_;
+    volatile float  makeup_;
+    volatile int32_t    paramsChanged_;
+};
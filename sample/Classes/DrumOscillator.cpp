@@ -0,0 +1,173 @@
+//
+//  DrumOscillator.cpp
+//  WISTSample
+//
+//  Created by Nobuhisa Okamura on 11/05/19.
+//  Copyright 2011 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include "DrumOscillator.h"
+
+//  ---------------------------------------------------------------------------
+//      CompressDrumSample
+//  ---------------------------------------------------------------------------
+static DrumSample*
+CompressDrumSample(const DrumSample& source)
+{
+    switch (source.GetNumberOfChannels())
+    {
+        case 1:
+            return new DrumSampleBlockFloat<1>(source);
+        case 2:
+            return new DrumSampleBlockFloat<2>(source);
+        default:
+            return NULL;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::DrumOscillator
+//  ---------------------------------------------------------------------------
+DrumOscillator::DrumOscillator(float samplingRate) :
+tgSamlingRate_(samplingRate),
+pcmSamlingRate_(tgSamlingRate_),
+transpose_(0),
+tune_(0),
+voice_(),
+sample_(NULL),
+decodeCache_(),
+trigger_(false)
+{
+    decodeCache_.blockNo = -1;
+    voice_.currentAddress = 0;
+    voice_.pitchOffset = 0x1000;    //  1.0
+    voice_.ampCoef = 0x7FFF >> 2;   //  amp gain
+    voice_.panCoef = 0;
+    voice_.isRunning = false;
+    voice_.decodeCache = &decodeCache_;
+    this->SetPanpot(64);
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::~DrumOscillator
+//  ---------------------------------------------------------------------------
+DrumOscillator::~DrumOscillator(void)
+{
+    delete sample_;
+    sample_ = NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::SetPanpot
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::SetPanpot(int pan)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    const int32_t   panOfs = CLIP(pan, 0, 127) - 64;
+    const int32_t   coef = (0x400000 + 66577 * panOfs) >> 8;
+    voice_.panCoef = CLIP(coef, 0, 0x7FFF);
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::GetPanGain
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::GetPanGain(float& left, float& right) const
+{
+    left = static_cast<float>(0x7FFF - voice_.panCoef) / 32768.0f;
+    right = static_cast<float>(voice_.panCoef) / 32768.0f;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::GetNumberOfChannels
+//  ---------------------------------------------------------------------------
+int
+DrumOscillator::GetNumberOfChannels(void) const
+{
+    return (sample_ != NULL) ? sample_->GetNumberOfChannels() : 1;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::CalculatePitch
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::CalculatePitch(void)
+{
+    //  20.12
+    const float pitch = static_cast<float>(transpose_) + static_cast<float>(tune_) / 100.0f;
+    voice_.pitchOffset = static_cast<uint32_t>(::pow(2.0, pitch / 12.0f) * 
+                                               ::pow(2.0, (::log(pcmSamlingRate_) - ::log(tgSamlingRate_)) / log(2.0)) * 
+                                               0x1000);
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::SetPcmSamplingRate
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::SetPcmSamplingRate(float fs)
+{
+    pcmSamlingRate_ = fs;
+    this->CalculatePitch();
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::TriggerOn
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::TriggerOn(void)
+{
+    trigger_ = true;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::SaveState
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::SaveState(State& state) const
+{
+    state.currentAddress = voice_.currentAddress;
+    state.isRunning = voice_.isRunning;
+    state.trigger = trigger_;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::RestoreState
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::RestoreState(const State& state)
+{
+    voice_.currentAddress = state.currentAddress;
+    voice_.isRunning = state.isRunning;
+    trigger_ = state.trigger;
+    decodeCache_.blockNo = -1;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::SetSample
+//  ---------------------------------------------------------------------------
+//  replaces the sample (NULL : none); the loader builds it, compressed here if asked
+void
+DrumOscillator::SetSample(DrumSample* sample, float samplingRate, bool compress)
+{
+    if ((sample != NULL) && compress)
+    {
+        DrumSample* compressed = CompressDrumSample(*sample);
+        if (compressed != NULL)
+        {
+            delete sample;
+            sample = compressed;
+        }
+    }
+    if (sample != NULL)
+    {
+        this->SetPcmSamplingRate(samplingRate);
+    }
+
+    voice_.isRunning = false;
+    decodeCache_.blockNo = -1;
+    delete sample_;
+    sample_ = sample;
+}
@@ -9,39 +9,108 @@
 #pragma once
 
 #include <vector>
+#include <CoreFoundation/CoreFoundation.h>
+#include "DrumSample.h"
+#include "DrumSampleBlockFloat.h"
 
 class DrumOscillator
 {
 public:
+    typedef struct {
+        uint32_t    currentAddress;
+        bool        isRunning;
+        bool        trigger;
+    } State;
+
     DrumOscillator(float samplingRate);
     ~DrumOscillator(void);
 
     void    SetPanpot(int pan);
+    void    GetPanGain(float& left, float& right) const;
+    int     GetNumberOfChannels(void) const;
 
-    void    Process(int16_t** output, int length);
+    void    Process(float* output, int stride, int length);
     void    TriggerOn(void);
+    bool    IsActive(void) const    { return trigger_ || voice_.isRunning; }
+    void    SaveState(State& state) const;
+    void    RestoreState(const State& state);
 
-    void    LoadAudioFileInResourceFolder(CFStringRef path);
+    void    LoadAudioFileInResourceFolder(CFStringRef path, bool compress = false);
+    void    SetSample(DrumSample* sample, float samplingRate, bool compress);   //  takes ownership
 
 private:
-    void    LoadAudioFile(CFStringRef path);
+    DrumOscillator(const DrumOscillator& other);                    //  not implemented
+    const DrumOscillator& operator= (const DrumOscillator& other);  //  not implemented
+
+    void    LoadAudioFile(CFStringRef path, bool compress);
     void    SetPcmSamplingRate(float fs);
     void    CalculatePitch(void);
-    int32_t GetOscOut(void);
-    int32_t ProcessAmp(int32_t oscOut);
-    void    ProcessPan(int32_t ampOut, int32_t& left, int32_t& right);
+    void    Render(float* output, int stride, int length);
 
     const float     tgSamlingRate_;
-    const int32_t   ampCoef_;
     float       pcmSamlingRate_;
     int32_t     transpose_;
     int32_t     tune_;
-    uint32_t    pitchOffset_;
-    int32_t     panCoef_;
-    bool        isValid_;
-    uint32_t    numberOfFrames_;
-    uint32_t    currentAddress_;
-    std::vector<int16_t>    pcmData_;
-    bool        isRunning_;
+    DrumVoiceState  voice_;
+    DrumSample*     sample_;
+    DrumDecodeCache decodeCache_;
     bool        trigger_;
 };
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::Render
+//  ---------------------------------------------------------------------------
+//  the kernel of the sample, called directly : qualified calls bypass the vtable and inline
+inline void
+DrumOscillator::Render(float* output, int stride, int length)
+{
+    switch (sample_->GetKernel())
+    {
+        case kDrumKernel_Int16:
+            static_cast<DrumSampleData<SampleFormatInt16, 1>*>(sample_)->DrumSampleData<SampleFormatInt16, 1>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_Int16 + 1:
+            static_cast<DrumSampleData<SampleFormatInt16, 2>*>(sample_)->DrumSampleData<SampleFormatInt16, 2>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_Int24:
+            static_cast<DrumSampleData<SampleFormatInt24, 1>*>(sample_)->DrumSampleData<SampleFormatInt24, 1>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_Int24 + 1:
+            static_cast<DrumSampleData<SampleFormatInt24, 2>*>(sample_)->DrumSampleData<SampleFormatInt24, 2>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_Float32:
+            static_cast<DrumSampleData<SampleFormatFloat32, 1>*>(sample_)->DrumSampleData<SampleFormatFloat32, 1>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_Float32 + 1:
+            static_cast<DrumSampleData<SampleFormatFloat32, 2>*>(sample_)->DrumSampleData<SampleFormatFloat32, 2>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_BlockFloat:
+            static_cast<DrumSampleBlockFloat<1>*>(sample_)->DrumSampleBlockFloat<1>::Render(voice_, output, stride, length);
+            break;
+        case kDrumKernel_BlockFloat + 1:
+            static_cast<DrumSampleBlockFloat<2>*>(sample_)->DrumSampleBlockFloat<2>::Render(voice_, output, stride, length);
+            break;
+        default:
+            sample_->Render(voice_, output, stride, length);
+            break;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::Process
+//  ---------------------------------------------------------------------------
+inline void
+DrumOscillator::Process(float* output, int stride, int length)
+{
+    if (trigger_)
+    {
+        voice_.isRunning = (sample_ != NULL);
+        voice_.currentAddress = 0;
+        decodeCache_.blockNo = -1;
+        trigger_ = false;
+    }
+    if (voice_.isRunning)
+    {
+        this->Render(output, stride, length);
+    }
+}
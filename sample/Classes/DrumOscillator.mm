@@ -10,181 +10,69 @@
 #include "DrumOscillator.h"
 
 //  ---------------------------------------------------------------------------
-//      DrumOscillator::DrumOscillator
-//  ---------------------------------------------------------------------------
-DrumOscillator::DrumOscillator(float samplingRate) :
-tgSamlingRate_(samplingRate),
-ampCoef_(0x7FFF >> 2),  //  amp gain
-pcmSamlingRate_(tgSamlingRate_),
-transpose_(0),
-tune_(0),
-pitchOffset_(0x1000),   //  1.0
-panCoef_(0),
-isValid_(false),
-numberOfFrames_(0),
-currentAddress_(0),
-pcmData_(),
-isRunning_(false),
-trigger_(false)
-{
-    this->SetPanpot(64);
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::~DrumOscillator
-//  ---------------------------------------------------------------------------
-DrumOscillator::~DrumOscillator(void)
-{
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::SetPanpot
-//  ---------------------------------------------------------------------------
-void
-DrumOscillator::SetPanpot(int pan)
-{
-#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
-    const int32_t   panOfs = CLIP(pan, 0, 127) - 64;
-    const int32_t   coef = (0x400000 + 66577 * panOfs) >> 8;
-    panCoef_ = CLIP(coef, 0, 0x7FFF);
-#undef CLIP
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::CalculatePitch
-//  ---------------------------------------------------------------------------
-void
-DrumOscillator::CalculatePitch(void)
-{
-    //  20.12
-    const float pitch = static_cast<float>(transpose_) + static_cast<float>(tune_) / 100.0f;
-    pitchOffset_ = static_cast<uint32_t>(::pow(2.0, pitch / 12.0f) * 
-                                         ::pow(2.0, (::log(pcmSamlingRate_) - ::log(tgSamlingRate_)) / log(2.0)) * 
-                                         0x1000);
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::SetPcmSamplingRate
-//  ---------------------------------------------------------------------------
-void
-DrumOscillator::SetPcmSamplingRate(float fs)
-{
-    pcmSamlingRate_ = fs;
-    this->CalculatePitch();
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::TriggerOn
+//      DrumOscillator::LoadAudioFileInResourceFolder
 //  ---------------------------------------------------------------------------
 void
-DrumOscillator::TriggerOn(void)
+DrumOscillator::LoadAudioFileInResourceFolder(CFStringRef path, bool compress)
 {
-    trigger_ = true;
+    NSString*   resourcePath = [[[NSBundle mainBundle] bundlePath] stringByAppendingPathComponent:(NSString*)path];
+    this->LoadAudioFile((CFStringRef)resourcePath, compress);
 }
 
 //  ---------------------------------------------------------------------------
-//      DrumOscillator::GetOscOut
+//      CreateDrumSample
 //  ---------------------------------------------------------------------------
-inline int32_t
-DrumOscillator::GetOscOut(void)
+//  select the render kernel for the file format, NULL if not supported
+template <int Channels>
+static inline DrumSampleBuilder*
+CreateDrumSample(const AudioStreamBasicDescription& format)
 {
-#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
-    int32_t result = 0;
-    if (isValid_ && isRunning_)
+    const bool  isFloat = ((format.mFormatFlags & kAudioFormatFlagIsFloat) != 0);
+    const bool  isSignedInteger = ((format.mFormatFlags & kAudioFormatFlagIsSignedInteger) != 0);
+    if (isFloat && (format.mBitsPerChannel == SampleFormatFloat32::kBitsPerSample))
     {
-        const uint32_t  addr = currentAddress_ >> 12;
-        if (addr < numberOfFrames_)
-        {
-            const uint32_t  nextAddr = addr + 1;
-            const int32_t   data = pcmData_[addr];
-            const int32_t   nextData = (nextAddr < numberOfFrames_) ? pcmData_[nextAddr] : 0;
-            const int32_t   interpolated = data + (((nextData - data) * static_cast<int32_t>(currentAddress_ & 0x0FFF)) >> 12);
-            result = CLIP(interpolated, -0x7FFF, 0x7FFF);
-            currentAddress_ += pitchOffset_;
-        }
-        else
-        {
-            isRunning_ = false;
-        }
+        return new DrumSampleData<SampleFormatFloat32, Channels>();
     }
-    return result;
-#undef CLIP
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::ProcessAmp
-//  ---------------------------------------------------------------------------
-inline int32_t
-DrumOscillator::ProcessAmp(int32_t oscOut)
-{
-#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
-    const int32_t   amp = (oscOut * ampCoef_) >> 15;
-    return CLIP(amp, -0x7FFF, 0x7FFF);
-#undef CLIP
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::ProcessPan
-//  ---------------------------------------------------------------------------
-inline void
-DrumOscillator::ProcessPan(int32_t ampOut, int32_t& left, int32_t& right)
-{
-    left = ((ampOut * (0x7FFF - panCoef_)) >> 15);
-    right = (ampOut * panCoef_) >> 15;
-}
-
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::Process
-//  ---------------------------------------------------------------------------
-void
-DrumOscillator::Process(int16_t** output, int length)
-{
-#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
-    if (trigger_)
+    else if (isSignedInteger && (format.mBitsPerChannel == SampleFormatInt16::kBitsPerSample))
     {
-        isRunning_ = true;
-        currentAddress_ = 0;
-        trigger_ = false;
+        return new DrumSampleData<SampleFormatInt16, Channels>();
     }
-    if (isRunning_)
+    else if (isSignedInteger && (format.mBitsPerChannel == SampleFormatInt24::kBitsPerSample))
     {
-        int16_t*    left = output[0];
-        int16_t*    right = output[1];
-        for (int frame = 0; frame < length; ++frame)
-        {
-            int32_t leftOut, rightOut;
-            this->ProcessPan(this->ProcessAmp(this->GetOscOut()), leftOut, rightOut);
-            leftOut += *left;
-            rightOut += *right;
-            *(left++) = CLIP(leftOut, -0x7FFF, 0x7FFF);
-            *(right++) = CLIP(rightOut, -0x7FFF, 0x7FFF);
-            if (!isRunning_)
-            {
-                break;
-            }
-        }
+        return new DrumSampleData<SampleFormatInt24, Channels>();
     }
-#undef CLIP
+    return NULL;
 }
 
-#pragma mark -
-//  ---------------------------------------------------------------------------
-//      DrumOscillator::LoadAudioFileInResourceFolder
-//  ---------------------------------------------------------------------------
-void
-DrumOscillator::LoadAudioFileInResourceFolder(CFStringRef path)
+static DrumSampleBuilder*
+CreateDrumSample(const AudioStreamBasicDescription& format)
 {
-    NSString*   resourcePath = [[[NSBundle mainBundle] bundlePath] stringByAppendingPathComponent:(NSString*)path];
-    this->LoadAudioFile((CFStringRef)resourcePath);
+    if ((format.mFormatID != kAudioFormatLinearPCM) ||
+        ((format.mFormatFlags & kAudioFormatFlagIsPacked) == 0) ||
+        ((format.mFormatFlags & kAudioFormatFlagIsNonInterleaved) != 0) ||
+        (format.mBytesPerFrame != format.mBitsPerChannel / 8 * format.mChannelsPerFrame))
+    {
+        return NULL;
+    }
+    switch (format.mChannelsPerFrame)
+    {
+        case 1:
+            return CreateDrumSample<1>(format);
+        case 2:
+            return CreateDrumSample<2>(format);
+        default:
+            return NULL;
+    }
 }
 
 //  ---------------------------------------------------------------------------
 //      DrumOscillator::LoadAudioFile
 //  ---------------------------------------------------------------------------
 void
-DrumOscillator::LoadAudioFile(CFStringRef path)
+DrumOscillator::LoadAudioFile(CFStringRef path, bool compress)
 {
-    bool    loaded = false;
+    DrumSample* sample = NULL;
+    float   samplingRate = tgSamlingRate_;
     NSURL*  url = [[[NSURL alloc] initFileURLWithPath:(NSString*)path isDirectory:NO] autorelease];
     ExtAudioFileRef fileRef = NULL;
     OSStatus    err = ::ExtAudioFileOpenURL((CFURLRef)url, &fileRef);
@@ -195,16 +83,11 @@ DrumOscillator::LoadAudioFile(CFStringRef path)
         err = ::ExtAudioFileGetProperty(fileRef, kExtAudioFileProperty_FileDataFormat, &size, &fileFormat);
         if (err == noErr)
         {
-            //bool    isNonInterleave = ((fileFormat.mFormatFlags & kAudioFormatFlagIsNonInterleaved) != 0);
-            if ((fileFormat.mFormatID == kAudioFormatLinearPCM) && 
-                (fileFormat.mBitsPerChannel == 16) && 
-                (fileFormat.mChannelsPerFrame == 1) && 
-                ((fileFormat.mFormatFlags & kAudioFormatFlagIsSignedInteger) != 0) && 
-                ((fileFormat.mFormatFlags & kAudioFormatFlagIsPacked) != 0))
+            DrumSampleBuilder*  builder = CreateDrumSample(fileFormat);
+            sample = builder;
+            if (builder != NULL)
             {
-                pcmData_.clear();
-                numberOfFrames_ = 0;
-                this->SetPcmSamplingRate((float)fileFormat.mSampleRate);
+                samplingRate = (float)fileFormat.mSampleRate;
 
                 const UInt32    tmpFrames = 1024;
                 std::vector<uint8_t>   tmpBuf(tmpFrames * fileFormat.mBytesPerFrame);
@@ -229,13 +112,7 @@ DrumOscillator::LoadAudioFile(CFStringRef path)
                     }
                     else
                     {
-                        int16_t*    src = static_cast<int16_t*>(bufList.mBuffers[0].mData);
-                        pcmData_.reserve(pcmData_.size() + frames);
-                        for (UInt32 i = 0; i < frames; ++i)
-                        {
-                            pcmData_.push_back(*(src++));
-                        }
-                        numberOfFrames_ += frames;
+                        builder->Append(bufList.mBuffers[0].mData, frames);
                     }
                 }
 
@@ -247,13 +124,8 @@ DrumOscillator::LoadAudioFile(CFStringRef path)
 #endif
                 if (flipPcm)
                 {
-                    for (size_t index = 0; index < numberOfFrames_; ++index)
-                    {
-                        pcmData_.at(index) = ::CFSwapInt16(pcmData_.at(index));
-                    }
+                    builder->SwapByteOrder();
                 }
-                
-                loaded = true;
             }
         }
     }
@@ -263,10 +135,5 @@ DrumOscillator::LoadAudioFile(CFStringRef path)
         fileRef = NULL;
     }
 
-    isValid_ = loaded;
-    if (!loaded)
-    {
-        pcmData_.clear();
-        numberOfFrames_ = 0;
-    }
+    this->SetSample(sample, samplingRate, compress);
 }
@@ -0,0 +1,211 @@
+//
+//  DrumSample.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <string.h>
+#include <vector>
+#include "SampleFormat.h"
+#include "BlockFloatCodec.h"
+
+//
+//  per-voice scratch of a compressed sample : the decoded block plus the first frame of the next one
+//
+typedef struct {
+    int32_t     blockNo;            //  -1 : empty
+    int32_t     samples[2][kBlockFloatFrames + 1];
+} DrumDecodeCache;
+
+//
+//  playback state of a voice, owned by DrumOscillator
+//
+typedef struct {
+    uint32_t    currentAddress;     //  20.12
+    uint32_t    pitchOffset;        //  20.12
+    int32_t     ampCoef;
+    int32_t     panCoef;
+    bool        isRunning;
+    DrumDecodeCache*    decodeCache;
+} DrumVoiceState;
+
+//  ---------------------------------------------------------------------------
+//      DrumKernelInterpolate
+//  ---------------------------------------------------------------------------
+static inline int32_t
+DrumKernelInterpolate(int32_t data, int32_t nextData, uint32_t address)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    const int32_t   interpolated = data + static_cast<int32_t>((static_cast<int64_t>(nextData - data) * static_cast<int32_t>(address & 0x0FFF)) >> 12);
+    return CLIP(interpolated, -0x7FFFFF, 0x7FFFFF);
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumKernelOutput
+//  ---------------------------------------------------------------------------
+//  amp 24-bit samples into the float lanes of the voice (pan is applied by the mixer)
+template <int Channels>
+static inline void
+DrumKernelOutput(const int32_t* oscOut, float gain, float* output)
+{
+    for (int ch = 0; ch < Channels; ++ch)
+    {
+        output[ch] = static_cast<float>(oscOut[ch]) * gain;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumKernelGain
+//  ---------------------------------------------------------------------------
+static inline float
+DrumKernelGain(const DrumVoiceState& voice)
+{
+    return static_cast<float>(voice.ampCoef) / (32768.0f * 8388608.0f);
+}
+
+//
+//  render kernels : storage format, + Channels - 1.
+//  DrumOscillator switches on them to call the kernel of its sample directly (inlined)
+//
+enum
+{
+    kDrumKernel_Other = -1,     //  virtual Render() only
+    kDrumKernel_Int16 = 0,
+    kDrumKernel_Int24 = 2,
+    kDrumKernel_Float32 = 4,
+    kDrumKernel_BlockFloat = 6,
+};
+
+template <int Base, int Channels> struct DrumKernelIndex
+{
+    enum { kKernel = ((Channels == 1) || (Channels == 2)) ? (Base + Channels - 1) : kDrumKernel_Other };
+};
+template <class Format, int Channels> struct DrumKernelOf                   { enum { kKernel = kDrumKernel_Other }; };
+template <int Channels> struct DrumKernelOf<SampleFormatInt16, Channels>    : DrumKernelIndex<kDrumKernel_Int16, Channels> {};
+template <int Channels> struct DrumKernelOf<SampleFormatInt24, Channels>    : DrumKernelIndex<kDrumKernel_Int24, Channels> {};
+template <int Channels> struct DrumKernelOf<SampleFormatFloat32, Channels>  : DrumKernelIndex<kDrumKernel_Float32, Channels> {};
+
+//
+//  sample storage + render kernel. The kernel is selected once when the file is loaded,
+//  Render() is called once per voice and block. It writes one lane per channel :
+//  output[frame * stride + ch], and leaves the frames after the end of the sample untouched.
+//
+class DrumSample
+{
+public:
+    DrumSample(int kernel) : kernel_(kernel)    {}
+    virtual ~DrumSample(void)   {}
+
+    int     GetKernel(void) const   { return kernel_; }
+    virtual int     GetNumberOfChannels(void) const = 0;
+    virtual uint32_t    GetNumberOfFrames(void) const = 0;
+    virtual void    ReadFrames(int32_t* dest, uint32_t startFrame, uint32_t frames) const = 0;  //  interleaved, 24-bit
+    virtual size_t  GetDataSize(void) const = 0;    //  bytes
+    virtual void    Render(DrumVoiceState& voice, float* output, int stride, int length) = 0;
+
+private:
+    const int   kernel_;
+};
+
+//
+//  a sample filled by the file loader : only the uncompressed storage can be built in place
+//
+class DrumSampleBuilder : public DrumSample
+{
+public:
+    DrumSampleBuilder(int kernel) : DrumSample(kernel)  {}
+
+    virtual void    Append(const void* data, uint32_t frames) = 0;   //  interleaved, stored format
+    virtual void    SwapByteOrder(void) = 0;
+};
+
+//  ---------------------------------------------------------------------------
+//      DrumSampleData
+//  ---------------------------------------------------------------------------
+template <class Format, int Channels>
+class DrumSampleData : public DrumSampleBuilder
+{
+public:
+    typedef typename Format::StorageType    StorageType;
+    enum
+    {
+        kFrameStride = Format::kStorageUnits * Channels,    //  StorageType per frame
+    };
+
+    DrumSampleData(void) :
+    DrumSampleBuilder(DrumKernelOf<Format, Channels>::kKernel),
+    pcmData_(),
+    numberOfFrames_(0)
+    {
+    }
+
+    int     GetNumberOfChannels(void) const     { return Channels; }
+    uint32_t    GetNumberOfFrames(void) const   { return numberOfFrames_; }
+
+    void    Append(const void* data, uint32_t frames)
+    {
+        const size_t    prevSize = pcmData_.size();
+        pcmData_.resize(prevSize + frames * kFrameStride);
+        ::memcpy(&pcmData_[prevSize], data, frames * kFrameStride * sizeof(StorageType));
+        numberOfFrames_ += frames;
+    }
+
+    void    SwapByteOrder(void)
+    {
+        for (size_t index = 0; index < pcmData_.size(); index += Format::kStorageUnits)
+        {
+            Format::SwapByteOrder(&pcmData_[index]);
+        }
+    }
+
+    void    ReadFrames(int32_t* dest, uint32_t startFrame, uint32_t frames) const
+    {
+        const StorageType*  src = &pcmData_[startFrame * kFrameStride];
+        for (uint32_t index = 0; index < frames * Channels; ++index, src += Format::kStorageUnits)
+        {
+            dest[index] = Format::Read(src);
+        }
+    }
+
+    size_t  GetDataSize(void) const     { return pcmData_.size() * sizeof(StorageType); }
+
+    void    Render(DrumVoiceState& voice, float* output, int stride, int length)
+    {
+        if (numberOfFrames_ == 0)
+        {
+            voice.isRunning = false;
+            return;
+        }
+        const StorageType*  data = &pcmData_[0];
+        const float gain = DrumKernelGain(voice);
+        for (int frame = 0; frame < length; ++frame, output += stride)
+        {
+            const uint32_t  addr = voice.currentAddress >> 12;
+            if (addr >= numberOfFrames_)
+            {
+                voice.isRunning = false;
+                break;
+            }
+            const StorageType*  src = data + addr * kFrameStride;
+            const bool  hasNext = (addr + 1 < numberOfFrames_);
+            int32_t oscOut[Channels];
+            for (int ch = 0; ch < Channels; ++ch)
+            {
+                const int32_t   sample = Format::Read(src + ch * Format::kStorageUnits);
+                const int32_t   nextSample = hasNext ? Format::Read(src + kFrameStride + ch * Format::kStorageUnits) : 0;
+                oscOut[ch] = DrumKernelInterpolate(sample, nextSample, voice.currentAddress);
+            }
+            DrumKernelOutput<Channels>(oscOut, gain, output);
+            voice.currentAddress += voice.pitchOffset;
+        }
+    }
+
+private:
+    std::vector<StorageType>    pcmData_;
+    uint32_t    numberOfFrames_;
+};
@@ -0,0 +1,114 @@
+//
+//  DrumSampleBlockFloat.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "DrumSample.h"
+#include "BlockFloatCodec.h"
+
+//
+//  compressed drum sample. Voices decode one block at a time into their DrumDecodeCache.
+//
+template <int Channels>
+class DrumSampleBlockFloat : public DrumSample
+{
+public:
+    typedef BlockFloatBlock<Channels>   Block;
+
+    DrumSampleBlockFloat(const DrumSample& source) :
+    DrumSample(DrumKernelIndex<kDrumKernel_BlockFloat, Channels>::kKernel),
+    blocks_(),
+    numberOfFrames_(source.GetNumberOfFrames())
+    {
+        const uint32_t  numOfBlocks = (numberOfFrames_ + kBlockFloatFrames - 1) / kBlockFloatFrames;
+        blocks_.resize(numOfBlocks);
+        int32_t tmp[kBlockFloatFrames * Channels];
+        for (uint32_t blockNo = 0; blockNo < numOfBlocks; ++blockNo)
+        {
+            const uint32_t  startFrame = blockNo * kBlockFloatFrames;
+            const uint32_t  frames = std::min<uint32_t>(numberOfFrames_ - startFrame, kBlockFloatFrames);
+            source.ReadFrames(tmp, startFrame, frames);
+            BlockFloatEncode<Channels>(tmp, frames, blocks_[blockNo]);
+        }
+    }
+
+    int     GetNumberOfChannels(void) const     { return Channels; }
+    uint32_t    GetNumberOfFrames(void) const   { return numberOfFrames_; }
+    size_t  GetDataSize(void) const     { return blocks_.size() * sizeof(Block); }
+
+    void    ReadFrames(int32_t* dest, uint32_t startFrame, uint32_t frames) const
+    {
+        for (uint32_t frame = startFrame; frame < startFrame + frames; ++frame)
+        {
+            const Block&    block = blocks_[frame / kBlockFloatFrames];
+            for (int ch = 0; ch < Channels; ++ch)
+            {
+                *(dest++) = BlockFloatSample<Channels>(block, ch, frame % kBlockFloatFrames);
+            }
+        }
+    }
+
+    void    Render(DrumVoiceState& voice, float* output, int stride, int length)
+    {
+        DrumDecodeCache*    cache = voice.decodeCache;
+        if ((numberOfFrames_ == 0) || (cache == NULL))
+        {
+            voice.isRunning = false;
+            return;
+        }
+        const float gain = DrumKernelGain(voice);
+        for (int frame = 0; frame < length; ++frame, output += stride)
+        {
+            const uint32_t  addr = voice.currentAddress >> 12;
+            if (addr >= numberOfFrames_)
+            {
+                voice.isRunning = false;
+                break;
+            }
+            const int32_t   blockNo = static_cast<int32_t>(addr / kBlockFloatFrames);
+            if (blockNo != cache->blockNo)
+            {
+                this->Decode(blockNo, cache);
+            }
+            const uint32_t  index = addr % kBlockFloatFrames;
+            int32_t oscOut[Channels];
+            for (int ch = 0; ch < Channels; ++ch)
+            {
+                oscOut[ch] = DrumKernelInterpolate(cache->samples[ch][index], cache->samples[ch][index + 1], voice.currentAddress);
+            }
+            DrumKernelOutput<Channels>(oscOut, gain, output);
+            voice.currentAddress += voice.pitchOffset;
+        }
+    }
+
+private:
+    void    Decode(int32_t blockNo, DrumDecodeCache* cache) const
+    {
+        const Block&    block = blocks_[blockNo];
+        const bool  hasNext = (blockNo + 1 < static_cast<int32_t>(blocks_.size()));
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+            BlockFloatDecode(block.low[ch], block.high[ch], block.shift[ch], cache->samples[ch]);
+            if (hasNext)
+            {
+                const Block&    nextBlock = blocks_[blockNo + 1];
+                cache->samples[ch][kBlockFloatFrames] = BlockFloatSample<Channels>(nextBlock, ch, 0);
+            }
+            else
+            {
+                cache->samples[ch][kBlockFloatFrames] = 0;
+            }
+        }
+        cache->blockNo = blockNo;
+    }
+
+    std::vector<Block>  blocks_;
+    uint32_t    numberOfFrames_;
+};
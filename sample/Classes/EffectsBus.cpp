@@ -0,0 +1,167 @@
+//
+//  EffectsBus.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <algorithm>
+#include "EffectsBus.h"
+#include "TempoDelay.h"
+#include "FdnReverb.h"
+#include "BusCompressor.h"
+#include "SimdTypes.h"
+
+static const float  kSilenceLevel = 0.00001f;   //  -100dB
+static const float  kMaxDelaySeconds = 2.0f;
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::EffectsBus
+//  ---------------------------------------------------------------------------
+EffectsBus::EffectsBus(float samplingRate, int maxBlockLength) :
+samplingRate_(samplingRate),
+maxBlockLength_(((maxBlockLength + kSimdWidth - 1) / kSimdWidth) * kSimdWidth),
+buffers_(maxBlockLength_ * kNumberOfStems),
+delay_(new TempoDelay(samplingRate, kMaxDelaySeconds, maxBlockLength_)),
+reverb_(new FdnReverb(samplingRate)),
+compressor_(new BusCompressor(samplingRate)),
+tempo_(120.0f),
+delaySteps_(3.0f)
+{
+    for (int sendNo = 0; sendNo < kNumberOfSends; ++sendNo)
+    {
+        isActive_[sendNo] = false;
+        silentFrames_[sendNo] = 0;
+        returnLevel_[sendNo] = 1.0f;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::~EffectsBus
+//  ---------------------------------------------------------------------------
+EffectsBus::~EffectsBus(void)
+{
+    delete compressor_;
+    compressor_ = NULL;
+    delete reverb_;
+    reverb_ = NULL;
+    delete delay_;
+    delay_ = NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetTempo
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetTempo(float tempo)
+{
+    if (tempo > 0.0f)
+    {
+        tempo_ = tempo;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetDelaySteps
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetDelaySteps(float steps)
+{
+    if (steps > 0.0f)
+    {
+        delaySteps_ = steps;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetDelayFeedback
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetDelayFeedback(float feedback)
+{
+    delay_->SetFeedback(feedback);
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetReverbTime
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetReverbTime(float seconds)
+{
+    reverb_->SetDecayTime(seconds);
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetReverbDamping
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetReverbDamping(float damping)
+{
+    reverb_->SetDamping(damping);
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::SetReturnLevel
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::SetReturnLevel(int sendNo, float level)
+{
+    if ((sendNo >= 0) && (sendNo < kNumberOfSends))
+    {
+        returnLevel_[sendNo] = level;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::IsSendActive
+//  ---------------------------------------------------------------------------
+//  true while the send has signal, and for the tail of the effect after that.
+//  The tail runs to -90dB, so an idle effect is not cleared : what is left in its lines
+//  is inaudible when the send comes back, and clearing them is a long memset on the audio thread.
+bool
+EffectsBus::IsSendActive(int sendNo, float tailSeconds, int length)
+{
+    const float peak = std::max(SimdPeak(this->GetSendBuffer(sendNo, 0), length),
+                                SimdPeak(this->GetSendBuffer(sendNo, 1), length));
+    if (peak > kSilenceLevel)
+    {
+        isActive_[sendNo] = true;
+        silentFrames_[sendNo] = 0;
+        return true;
+    }
+    if (!isActive_[sendNo])
+    {
+        return false;
+    }
+    silentFrames_[sendNo] += length;
+    if (silentFrames_[sendNo] > static_cast<int>(tailSeconds * samplingRate_))
+    {
+        isActive_[sendNo] = false;
+    }
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      EffectsBus::Process
+//  ---------------------------------------------------------------------------
+void
+EffectsBus::Process(int length)
+{
+    float*  masterLeft = this->GetMasterBuffer(0);
+    float*  masterRight = this->GetMasterBuffer(1);
+
+    delay_->SetDelayTime(delaySteps_ * 60.0f / (tempo_ * 4.0f));
+    if (this->IsSendActive(kSend_Delay, delay_->GetTailSeconds(), length))
+    {
+        delay_->Process(this->GetSendBuffer(kSend_Delay, 0), this->GetSendBuffer(kSend_Delay, 1),
+                        masterLeft, masterRight, returnLevel_[kSend_Delay], length);
+    }
+    if (this->IsSendActive(kSend_Reverb, reverb_->GetTailSeconds(), length))
+    {
+        reverb_->Process(this->GetSendBuffer(kSend_Reverb, 0), this->GetSendBuffer(kSend_Reverb, 1),
+                         masterLeft, masterRight, returnLevel_[kSend_Reverb], length);
+    }
+
+    compressor_->Process(masterLeft, masterRight, length);
+}
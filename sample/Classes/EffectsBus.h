@@ -0,0 +1,68 @@
+//
+//  EffectsBus.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "AlignedBuffer.h"
+
+//
+//  send / return effects and the master insert.
+//  Per block : the voices are mixed into the stems (master L/R, then L/R of each send),
+//  then Process() adds the effect returns to the master and runs the compressor on it.
+//  A return effect is only processed while its send carries signal or its tail is ringing.
+//
+class EffectsBus
+{
+public:
+    enum
+    {
+        kSend_Delay = 0,
+        kSend_Reverb,
+        kNumberOfSends,
+        kNumberOfStems = 2 + kNumberOfSends * 2,
+    };
+
+    EffectsBus(float samplingRate, int maxBlockLength);
+    ~EffectsBus(void);
+
+    //  any thread; applied at the next Process()
+    void    SetTempo(float tempo);
+    void    SetDelaySteps(float steps);     //  delay time in 16th notes
+    void    SetDelayFeedback(float feedback);
+    void    SetReverbTime(float seconds);
+    void    SetReverbDamping(float damping);
+    void    SetReturnLevel(int sendNo, float level);
+    class BusCompressor*    GetCompressor(void) { return compressor_; }
+
+    //  audio thread
+    float*  GetStem(int stemNo)                 { return &buffers_[maxBlockLength_ * stemNo]; }
+    float*  GetMasterBuffer(int ch)             { return this->GetStem(ch); }
+    float*  GetSendBuffer(int sendNo, int ch)   { return this->GetStem(2 + sendNo * 2 + ch); }
+    void    Process(int length);
+
+private:
+    EffectsBus(const EffectsBus& other);                    //  not implemented
+    const EffectsBus& operator= (const EffectsBus& other);  //  not implemented
+
+    bool    IsSendActive(int sendNo, float tailSeconds, int length);
+
+    const float samplingRate_;
+    const int   maxBlockLength_;
+    AlignedBuffer<float>    buffers_;   //  stems
+    class TempoDelay*   delay_;
+    class FdnReverb*    reverb_;
+    class BusCompressor*    compressor_;
+    bool    isActive_[kNumberOfSends];
+    int     silentFrames_[kNumberOfSends];
+
+    //  parameters, written by the control thread
+    volatile float  tempo_;
+    volatile float  delaySteps_;
+    volatile float  returnLevel_[kNumberOfSends];
+};
@@ -0,0 +1,188 @@
+//
+//  EventOutput.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <time.h>
+#include "EventOutput.h"
+
+enum
+{
+    kSendBatchSize = 64,
+    kSenderIntervalNanoSec = 1000000,   //  the events are stamped, the sender only has to stay ahead
+};
+
+//  ---------------------------------------------------------------------------
+//      FileEventSink::FileEventSink
+//  ---------------------------------------------------------------------------
+FileEventSink::FileEventSink(const char* path) :
+file_(::fopen(path, "w"))
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      FileEventSink::~FileEventSink
+//  ---------------------------------------------------------------------------
+FileEventSink::~FileEventSink(void)
+{
+    if (file_ != NULL)
+    {
+        ::fclose(file_);
+        file_ = NULL;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      FileEventSink::Send
+//  ---------------------------------------------------------------------------
+void
+FileEventSink::Send(const OutputEvent* events, int numberOfEvents)
+{
+    static const char*  kTypeNames[] = { "clock", "start", "stop", "note" };
+    if (file_ == NULL)
+    {
+        return;
+    }
+    for (int index = 0; index < numberOfEvents; ++index)
+    {
+        const OutputEvent&  event = events[index];
+        const bool  isKnown = (event.type >= kOutputEvent_Clock) && (event.type <= kOutputEvent_Note);
+        ::fprintf(file_, "%llu %s %d\n", static_cast<unsigned long long>(event.hostTime),
+                  isKnown ? kTypeNames[event.type] : "unknown", static_cast<int>(event.value));
+    }
+    ::fflush(file_);
+}
+
+#pragma mark -
+//  ---------------------------------------------------------------------------
+//      EventOutput::EventOutput
+//  ---------------------------------------------------------------------------
+EventOutput::EventOutput(int capacity) :
+queue_(capacity),
+sink_(NULL),
+droppedCount_(0),
+senderThread_(),
+senderRunning_(false),
+senderQuit_(false)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::~EventOutput
+//  ---------------------------------------------------------------------------
+EventOutput::~EventOutput(void)
+{
+    this->Stop();
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::SetSink
+//  ---------------------------------------------------------------------------
+void
+EventOutput::SetSink(EventSink* sink)
+{
+    if (!senderRunning_)
+    {
+        sink_ = sink;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::Start
+//  ---------------------------------------------------------------------------
+bool
+EventOutput::Start(void)
+{
+    if (!senderRunning_)
+    {
+        senderQuit_ = false;
+        senderRunning_ = (::pthread_create(&senderThread_, NULL, EventOutput::SenderThreadEntry, this) == 0);
+    }
+    return senderRunning_;
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::Stop
+//  ---------------------------------------------------------------------------
+void
+EventOutput::Stop(void)
+{
+    if (senderRunning_)
+    {
+        senderRunning_ = false;
+        senderQuit_ = true;
+        AtomicMemoryBarrier();
+        ::pthread_join(senderThread_, NULL);
+        this->Drain();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::Push
+//  ---------------------------------------------------------------------------
+void
+EventOutput::Push(const OutputEvent& event)
+{
+    if (!queue_.Push(event))
+    {
+        ++droppedCount_;    //  only written by the audio thread
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::Drain
+//  ---------------------------------------------------------------------------
+void
+EventOutput::Drain(void)
+{
+    OutputEvent batch[kSendBatchSize];
+    int numOfEvents = 0;
+    while (queue_.Pop(batch[numOfEvents]))
+    {
+        if (++numOfEvents == kSendBatchSize)
+        {
+            if (sink_ != NULL)
+            {
+                sink_->Send(batch, numOfEvents);
+            }
+            numOfEvents = 0;
+        }
+    }
+    if ((numOfEvents > 0) && (sink_ != NULL))
+    {
+        sink_->Send(batch, numOfEvents);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::RunSender
+//  ---------------------------------------------------------------------------
+void
+EventOutput::RunSender(void)
+{
+    while (true)
+    {
+        AtomicMemoryBarrier();
+        if (senderQuit_)
+        {
+            break;
+        }
+        this->Drain();
+        struct timespec interval = { 0, kSenderIntervalNanoSec };
+        ::nanosleep(&interval, NULL);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      EventOutput::SenderThreadEntry                              [static]
+//  ---------------------------------------------------------------------------
+void*
+EventOutput::SenderThreadEntry(void* arg)
+{
+    EventOutput*    output = reinterpret_cast<EventOutput*>(arg);
+    output->RunSender();
+    return NULL;
+}
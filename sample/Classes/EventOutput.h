@@ -0,0 +1,97 @@
+//
+//  EventOutput.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "SpscQueue.h"
+
+//
+//  output event type
+//
+enum
+{
+    kOutputEvent_Clock = 0,     //  24 PPQN
+    kOutputEvent_Start,
+    kOutputEvent_Stop,
+    kOutputEvent_Note,          //  value : track number
+};
+
+//  hostTime : when the frame of the event leaves the audio output, 0 if unknown
+typedef struct {
+    uint64_t    hostTime;
+    int32_t     type;
+    int32_t     value;
+} OutputEvent;
+
+//
+//  destination of the output events, called on the sender thread
+//
+class EventSink
+{
+public:
+    virtual ~EventSink(void)    {}
+    virtual void    Send(const OutputEvent* events, int numberOfEvents) = 0;
+};
+
+//
+//  writes one line per event : "hostTime type value"
+//
+class FileEventSink : public EventSink
+{
+public:
+    FileEventSink(const char* path);
+    ~FileEventSink(void);
+
+    bool    IsOpen(void) const  { return file_ != NULL; }
+    void    Send(const OutputEvent* events, int numberOfEvents);
+
+private:
+    FileEventSink(const FileEventSink& other);                      //  not implemented
+    const FileEventSink& operator= (const FileEventSink& other);    //  not implemented
+
+    FILE*   file_;
+};
+
+//
+//  The audio thread pushes timestamped events without blocking; a sender thread drains
+//  them into the sink. Events that do not fit into the queue are dropped and counted.
+//
+class EventOutput
+{
+public:
+    EventOutput(int capacity = 1024);
+    ~EventOutput(void);
+
+    //  control thread
+    void    SetSink(EventSink* sink);   //  while stopped
+    bool    Start(void);
+    void    Stop(void);
+
+    //  audio thread
+    void    Push(const OutputEvent& event);
+    void    CountDropped(uint32_t numberOfEvents)   { droppedCount_ += numberOfEvents; }    //  lost before Push
+    uint32_t    GetDroppedCount(void) const     { return droppedCount_; }
+
+private:
+    EventOutput(const EventOutput& other);                      //  not implemented
+    const EventOutput& operator= (const EventOutput& other);    //  not implemented
+
+    void    Drain(void);
+    void    RunSender(void);
+    static void*    SenderThreadEntry(void* arg);
+
+    SpscQueue<OutputEvent>  queue_;
+    EventSink*  sink_;
+    volatile uint32_t   droppedCount_;
+    pthread_t       senderThread_;
+    bool            senderRunning_;
+    volatile bool   senderQuit_;
+};
@@ -0,0 +1,229 @@
+//
+//  FdnReverb.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include <algorithm>
+#include "FdnReverb.h"
+#include "AtomicOps.h"
+
+//  mutually prime line lengths at 44.1kHz
+static const int    kLineLengths[FdnReverb::kNumberOfLines] = { 1433, 1601, 1867, 2053 };
+
+//  ---------------------------------------------------------------------------
+//      LinesTotalLength
+//  ---------------------------------------------------------------------------
+static int
+LinesTotalLength(float samplingRate)
+{
+    int total = 0;
+    for (int lineNo = 0; lineNo < FdnReverb::kNumberOfLines; ++lineNo)
+    {
+        total += static_cast<int>(kLineLengths[lineNo] * samplingRate / 44100.0f) + 1;
+    }
+    return total;
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::FdnReverb
+//  ---------------------------------------------------------------------------
+FdnReverb::FdnReverb(float samplingRate) :
+samplingRate_(samplingRate),
+lines_(LinesTotalLength(samplingRate)),
+chunk_(kChunkFrames * kNumberOfLines),
+lowpass_(SimdSplat(0.0f)),
+feedbackGain_(SimdSplat(0.0f)),
+dampingCoef_(SimdSplat(0.0f)),
+decayTime_(1.8f),
+damping_(0.3f),
+paramsChanged_(1)
+{
+    int offset = 0;
+    for (int lineNo = 0; lineNo < kNumberOfLines; ++lineNo)
+    {
+        lineLength_[lineNo] = static_cast<int>(kLineLengths[lineNo] * samplingRate / 44100.0f) + 1;
+        lineOffset_[lineNo] = offset;
+        position_[lineNo] = 0;
+        offset += lineLength_[lineNo];
+    }
+    this->UpdateCoefficients();
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::~FdnReverb
+//  ---------------------------------------------------------------------------
+FdnReverb::~FdnReverb(void)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::SetDecayTime
+//  ---------------------------------------------------------------------------
+void
+FdnReverb::SetDecayTime(float seconds)
+{
+    decayTime_ = (seconds > 0.1f) ? seconds : 0.1f;
+    AtomicStore32(&paramsChanged_, 1);
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::SetDamping
+//  ---------------------------------------------------------------------------
+void
+FdnReverb::SetDamping(float damping)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    damping_ = CLIP(damping, 0.0f, 0.95f);
+    AtomicStore32(&paramsChanged_, 1);
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::GetTailSeconds
+//  ---------------------------------------------------------------------------
+//  time to -90dB
+float
+FdnReverb::GetTailSeconds(void) const
+{
+    return decayTime_ * 1.5f;
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::Clear
+//  ---------------------------------------------------------------------------
+void
+FdnReverb::Clear(void)
+{
+    lines_.Clear();
+    lowpass_ = SimdSplat(0.0f);
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::UpdateCoefficients
+//  ---------------------------------------------------------------------------
+void
+FdnReverb::UpdateCoefficients(void)
+{
+    const float decayTime = decayTime_;
+    for (int lineNo = 0; lineNo < kNumberOfLines; ++lineNo)
+    {
+        //  -60dB after decayTime through this line
+        feedbackGain_[lineNo] = ::powf(10.0f, -3.0f * lineLength_[lineNo] / (samplingRate_ * decayTime));
+    }
+    dampingCoef_ = SimdSplat(1.0f - damping_);
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::Gather
+//  ---------------------------------------------------------------------------
+//  the next length taps of every line, as one vector per frame
+void
+FdnReverb::Gather(SimdFloat4* taps, int length) const
+{
+    const float*    lines = lines_.Get();
+    for (int lineNo = 0; lineNo < kNumberOfLines; ++lineNo)
+    {
+        const float*    line = lines + lineOffset_[lineNo];
+        int position = position_[lineNo];
+        int frame = 0;
+        while (frame < length)
+        {
+            const int   run = std::min(length - frame, lineLength_[lineNo] - position);
+            for (int index = 0; index < run; ++index)
+            {
+                taps[frame + index][lineNo] = line[position + index];
+            }
+            frame += run;
+            position = (position + run < lineLength_[lineNo]) ? position + run : 0;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::Scatter
+//  ---------------------------------------------------------------------------
+//  write the feedback where the taps were read, and advance the lines
+void
+FdnReverb::Scatter(const SimdFloat4* feed, int length)
+{
+    float*  lines = lines_.Get();
+    for (int lineNo = 0; lineNo < kNumberOfLines; ++lineNo)
+    {
+        float*  line = lines + lineOffset_[lineNo];
+        int position = position_[lineNo];
+        int frame = 0;
+        while (frame < length)
+        {
+            const int   run = std::min(length - frame, lineLength_[lineNo] - position);
+            for (int index = 0; index < run; ++index)
+            {
+                line[position + index] = feed[frame + index][lineNo];
+            }
+            frame += run;
+            position = (position + run < lineLength_[lineNo]) ? position + run : 0;
+        }
+        position_[lineNo] = position;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::ProcessChunk
+//  ---------------------------------------------------------------------------
+inline void
+FdnReverb::ProcessChunk(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float outGain, int length)
+{
+    SimdFloat4* chunk = reinterpret_cast<SimdFloat4*>(chunk_.Get());
+    this->Gather(chunk, length);
+
+    SimdFloat4  lowpass = lowpass_;
+    const SimdFloat4    feedbackGain = feedbackGain_;
+    const SimdFloat4    dampingCoef = dampingCoef_;
+    const SimdFloat4    half = SimdSplat(0.5f);
+    const SimdFloat4    signPairs = { 1.0f, -1.0f, 1.0f, -1.0f };
+    const SimdFloat4    signHalves = { 1.0f, 1.0f, -1.0f, -1.0f };
+    for (int frame = 0; frame < length; ++frame)
+    {
+        const SimdFloat4    taps = chunk[frame];
+        lowpass += dampingCoef * (taps - lowpass);
+        const SimdFloat4    fb = lowpass * feedbackGain;
+
+        //  Hadamard as two butterfly stages, scaled to stay unitary
+        const SimdFloat4    pairs = SimdSwapPairs(fb) + fb * signPairs;
+        const SimdFloat4    mixed = SimdSwapHalves(pairs) + pairs * signHalves;
+        const float in = (inLeft[frame] + inRight[frame]) * 0.5f;
+        chunk[frame] = mixed * half + SimdSplat(in);
+
+        //  lanes 0 / 1 : taps 0 + 2 / 1 + 3
+        const SimdFloat4    out = taps + SimdSwapHalves(taps);
+        outLeft[frame] += out[0] * outGain;
+        outRight[frame] += out[1] * outGain;
+    }
+    lowpass_ = lowpass;
+
+    this->Scatter(chunk, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      FdnReverb::Process
+//  ---------------------------------------------------------------------------
+void
+FdnReverb::Process(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float returnLevel, int length)
+{
+    if (AtomicCompareAndSwap32(1, 0, &paramsChanged_))
+    {
+        this->UpdateCoefficients();
+    }
+
+    const float outGain = returnLevel * 0.5f;
+    int offset = 0;
+    while (offset < length)
+    {
+        const int   frames = std::min<int>(length - offset, kChunkFrames);
+        this->ProcessChunk(inLeft + offset, inRight + offset, outLeft + offset, outRight + offset, outGain, frames);
+        offset += frames;
+    }
+}
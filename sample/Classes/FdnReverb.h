@@ -0,0 +1,69 @@
+//
+//  FdnReverb.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "AlignedBuffer.h"
+#include "SimdTypes.h"
+
+//
+//  4 line feedback delay network reverb.
+//  The lines are the lanes of a SimdFloat4, mixed through a 4x4 Hadamard matrix with
+//  one-pole damping in the loop. A chunk shorter than the shortest line never reads what
+//  it writes, so the taps of the chunk are gathered first, the loop runs on vectors only,
+//  and the feedback is scattered back at the end.
+//
+class FdnReverb
+{
+public:
+    enum
+    {
+        kNumberOfLines = kSimdWidth,
+    };
+
+    FdnReverb(float samplingRate);
+    ~FdnReverb(void);
+
+    void    SetDecayTime(float seconds);    //  RT60
+    void    SetDamping(float damping);      //  0 (bright) .. 1 (dark)
+    float   GetTailSeconds(void) const;
+    void    Clear(void);
+
+    //  out += reverb(in) * returnLevel
+    void    Process(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float returnLevel, int length);
+
+private:
+    FdnReverb(const FdnReverb& other);                      //  not implemented
+    const FdnReverb& operator= (const FdnReverb& other);    //  not implemented
+
+    enum
+    {
+        kChunkFrames = 256,
+    };
+
+    void    UpdateCoefficients(void);
+    void    Gather(SimdFloat4* taps, int length) const;
+    void    Scatter(const SimdFloat4* feed, int length);
+    void    ProcessChunk(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float outGain, int length);
+
+    const float samplingRate_;
+    int     lineLength_[kNumberOfLines];
+    int     lineOffset_[kNumberOfLines];
+    int     position_[kNumberOfLines];
+    AlignedBuffer<float>    lines_;
+    AlignedBuffer<float>    chunk_;     //  taps, then feedback, of a chunk : [frame][line]
+    SimdFloat4  lowpass_;
+    SimdFloat4  feedbackGain_;
+    SimdFloat4  dampingCoef_;
+
+    //  parameters, written by the control thread
+    volatile float  decayTime_;
+    volatile float  damping_;
+    volatile int32_t    paramsChanged_;
+};
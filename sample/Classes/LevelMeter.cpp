@@ -0,0 +1,111 @@
+//
+//  LevelMeter.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include <algorithm>
+#include "LevelMeter.h"
+#include "SimdTypes.h"
+
+//  ---------------------------------------------------------------------------
+//      LevelMeter::LevelMeter
+//  ---------------------------------------------------------------------------
+LevelMeter::LevelMeter(float samplingRate, int numberOfChannels) :
+samplingRate_(samplingRate),
+numberOfChannels_(std::min<int>(numberOfChannels, kMaxChannels)),
+levels_(),
+published_()
+{
+    ::memset(&levels_, 0, sizeof(levels_));
+    published_.Write(levels_);
+}
+
+//  ---------------------------------------------------------------------------
+//      LevelMeter::ProcessInterleaved
+//  ---------------------------------------------------------------------------
+//  the channels are measured 4 at once, stride must cover them rounded up to 4
+void
+LevelMeter::ProcessInterleaved(const float* buffer, int stride, int length)
+{
+    SimdFloat4  peak[kMaxChannels / kSimdWidth];
+    SimdFloat4  squareSum[kMaxChannels / kSimdWidth];
+    const int   numOfGroups = (numberOfChannels_ + kSimdWidth - 1) / kSimdWidth;
+    for (int groupNo = 0; groupNo < numOfGroups; ++groupNo)
+    {
+        peak[groupNo] = SimdSplat(0.0f);
+        squareSum[groupNo] = SimdSplat(0.0f);
+    }
+    for (int frame = 0; frame < length; ++frame)
+    {
+        const float*    src = buffer + frame * stride;
+        for (int groupNo = 0; groupNo < numOfGroups; ++groupNo)
+        {
+            const SimdFloat4    value = SimdLoadUnaligned(src + groupNo * kSimdWidth);
+            peak[groupNo] = SimdMax(peak[groupNo], SimdAbs(value));
+            squareSum[groupNo] += value * value;
+        }
+    }
+    float   blockPeak[kMaxChannels];
+    float   blockSquareSum[kMaxChannels];
+    for (int groupNo = 0; groupNo < numOfGroups; ++groupNo)
+    {
+        SimdStoreUnaligned(blockPeak + groupNo * kSimdWidth, peak[groupNo]);
+        SimdStoreUnaligned(blockSquareSum + groupNo * kSimdWidth, squareSum[groupNo]);
+    }
+    this->Publish(blockPeak, blockSquareSum, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      LevelMeter::ProcessPlanar
+//  ---------------------------------------------------------------------------
+void
+LevelMeter::ProcessPlanar(const float* const* channels, int length)
+{
+    float   blockPeak[kMaxChannels];
+    float   blockSquareSum[kMaxChannels];
+    const int   numOfVectors = length / kSimdWidth;
+    for (int ch = 0; ch < numberOfChannels_; ++ch)
+    {
+        const float*    src = channels[ch];
+        const SimdFloat4*   vec = reinterpret_cast<const SimdFloat4*>(src);
+        SimdFloat4  squareSum = SimdSplat(0.0f);
+        for (int index = 0; index < numOfVectors; ++index)
+        {
+            squareSum += vec[index] * vec[index];
+        }
+        float   sum = squareSum[0] + squareSum[1] + squareSum[2] + squareSum[3];
+        for (int index = numOfVectors * kSimdWidth; index < length; ++index)
+        {
+            sum += src[index] * src[index];
+        }
+        blockPeak[ch] = SimdPeak(src, length);
+        blockSquareSum[ch] = sum;
+    }
+    this->Publish(blockPeak, blockSquareSum, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      LevelMeter::Publish
+//  ---------------------------------------------------------------------------
+void
+LevelMeter::Publish(const float* blockPeak, const float* blockSquareSum, int length)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+    //  -20dB in 1.5 sec, 300 msec average
+    const float seconds = length / samplingRate_;
+    const float peakFall = ::powf(0.1f, seconds / 1.5f);
+    const float rmsCoef = 1.0f - ::expf(-seconds / 0.3f);
+    for (int ch = 0; ch < numberOfChannels_; ++ch)
+    {
+        levels_.peak[ch] = std::max(blockPeak[ch], levels_.peak[ch] * peakFall);
+        levels_.meanSquare[ch] += (blockSquareSum[ch] / length - levels_.meanSquare[ch]) * rmsCoef;
+    }
+    published_.Write(levels_);
+}
@@ -0,0 +1,51 @@
+//
+//  LevelMeter.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include "Seqlock.h"
+
+//
+//  Peak and RMS of up to kMaxChannels channels, measured per processed block and
+//  published for any thread to read without blocking the one that processes.
+//  The peak falls back 20 dB in 1.5 sec, the RMS is averaged over ~300 msec.
+//
+class LevelMeter
+{
+public:
+    enum
+    {
+        kMaxChannels = 16,
+    };
+
+    typedef struct {
+        float   peak[kMaxChannels];         //  linear
+        float   meanSquare[kMaxChannels];   //  sqrt() for the RMS
+    } Levels;
+
+    LevelMeter(float samplingRate, int numberOfChannels);
+
+    //  one processing thread
+    void    ProcessInterleaved(const float* buffer, int stride, int length);    //  buffer[frame * stride + ch]
+    void    ProcessPlanar(const float* const* channels, int length);            //  16-byte aligned channels
+
+    //  any thread
+    int     GetNumberOfChannels(void) const     { return numberOfChannels_; }
+    void    Read(Levels& levels) const          { published_.Read(levels); }
+
+private:
+    LevelMeter(const LevelMeter& other);                        //  not implemented
+    const LevelMeter& operator= (const LevelMeter& other);      //  not implemented
+
+    void    Publish(const float* blockPeak, const float* blockSquareSum, int length);
+
+    const float samplingRate_;
+    const int   numberOfChannels_;
+    Levels      levels_;            //  processing thread
+    Seqlock<Levels> published_;
+};
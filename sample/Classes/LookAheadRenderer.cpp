@@ -0,0 +1,289 @@
+//
+//  LookAheadRenderer.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <mach/mach.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "LookAheadRenderer.h"
+#include "AtomicOps.h"
+
+static const int64_t    kNotInvalidated = -1;
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::LookAheadRenderer
+//  ---------------------------------------------------------------------------
+LookAheadRenderer::LookAheadRenderer(LookAheadSource* source, int numberOfStems, int blockLength, int numberOfBlocks) :
+source_(source),
+numberOfStems_(numberOfStems),
+blockLength_(blockLength),
+numberOfBlocks_(std::max(numberOfBlocks, 2)),
+stems_(numberOfStems * blockLength * numberOfBlocks_),
+counters_(0),
+invalidFrom_(kNotInvalidated),
+underrunCount_(0),
+readPosition_(0),
+isBlockValid_(false),
+workerThread_(),
+workerRunning_(false),
+workerWake_(),
+workerQuit_(false)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::~LookAheadRenderer
+//  ---------------------------------------------------------------------------
+LookAheadRenderer::~LookAheadRenderer(void)
+{
+    this->Stop();
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Start
+//  ---------------------------------------------------------------------------
+bool
+LookAheadRenderer::Start(void)
+{
+    if (workerRunning_)
+    {
+        return true;
+    }
+    if (::semaphore_create(::mach_task_self(), &workerWake_, SYNC_POLICY_FIFO, 0) != KERN_SUCCESS)
+    {
+        return false;
+    }
+    AtomicStore64(&counters_, 0);
+    AtomicStore64(&invalidFrom_, kNotInvalidated);
+    readPosition_ = 0;
+    isBlockValid_ = false;
+    workerQuit_ = false;
+
+    //  not real-time : the worker only has to stay ahead, it has no deadline of its own
+    workerRunning_ = (::pthread_create(&workerThread_, NULL, LookAheadRenderer::WorkerThreadEntry, this) == 0);
+    if (!workerRunning_)
+    {
+        ::semaphore_destroy(::mach_task_self(), workerWake_);
+    }
+    return workerRunning_;
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Stop
+//  ---------------------------------------------------------------------------
+void
+LookAheadRenderer::Stop(void)
+{
+    if (workerRunning_)
+    {
+        workerRunning_ = false;
+        workerQuit_ = true;
+        AtomicMemoryBarrier();
+        ::semaphore_signal(workerWake_);
+        ::pthread_join(workerThread_, NULL);
+        ::semaphore_destroy(::mach_task_self(), workerWake_);
+
+        //  forget what was rendered but not played
+        const int64_t   counters = AtomicLoad64(&counters_);
+        const uint32_t  readBlock = ReadBlock(counters);
+        if (static_cast<int32_t>(WriteBlock(counters) - readBlock) > 0)
+        {
+            source_->RestoreCheckpoint(readBlock % numberOfBlocks_);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Invalidate
+//  ---------------------------------------------------------------------------
+void
+LookAheadRenderer::Invalidate(uint64_t position)
+{
+    const int64_t   value = static_cast<int64_t>(position);
+    while (true)
+    {
+        const int64_t   prev = AtomicLoad64(&invalidFrom_);
+        if ((prev != kNotInvalidated) && (prev <= value))
+        {
+            break;
+        }
+        if (AtomicCompareAndSwap64(prev, value, &invalidFrom_))
+        {
+            break;
+        }
+    }
+    if (workerRunning_)
+    {
+        ::semaphore_signal(workerWake_);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::GetPlayedPosition
+//  ---------------------------------------------------------------------------
+uint64_t
+LookAheadRenderer::GetPlayedPosition(void)
+{
+    return static_cast<uint64_t>(ReadBlock(AtomicLoad64(&counters_))) * blockLength_;
+}
+
+#pragma mark - audio thread
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Claim
+//  ---------------------------------------------------------------------------
+//  take block blockNo (== R) for reading, false if the worker has not rendered it yet
+inline bool
+LookAheadRenderer::Claim(uint32_t blockNo)
+{
+    while (true)
+    {
+        const int64_t   counters = AtomicLoad64(&counters_);
+        const uint32_t  writeBlock = WriteBlock(counters);
+        const bool  isReady = (static_cast<int32_t>(writeBlock - blockNo) > 0);
+        if (AtomicCompareAndSwap64(counters, Pack(blockNo + 1, writeBlock), &counters_))
+        {
+            return isReady;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Read
+//  ---------------------------------------------------------------------------
+void
+LookAheadRenderer::Read(float* const* dest, int length)
+{
+    bool    claimed = false;
+    int     done = 0;
+    while (done < length)
+    {
+        const uint32_t  blockNo = static_cast<uint32_t>(readPosition_ / blockLength_);
+        const int   offset = static_cast<int>(readPosition_ % blockLength_);
+        if (offset == 0)
+        {
+            isBlockValid_ = this->Claim(blockNo);
+            if (isBlockValid_)
+            {
+                source_->BlockClaimed(blockNo % numberOfBlocks_, readPosition_);
+            }
+            else
+            {
+                ++underrunCount_;   //  only written here
+            }
+            claimed = true;
+        }
+        const int   frames = std::min(length - done, blockLength_ - offset);
+        const int   slotNo = blockNo % numberOfBlocks_;
+        for (int stemNo = 0; stemNo < numberOfStems_; ++stemNo)
+        {
+            if (isBlockValid_)
+            {
+                ::memcpy(dest[stemNo] + done, this->GetStem(slotNo, stemNo) + offset, frames * sizeof(float));
+            }
+            else
+            {
+                ::memset(dest[stemNo] + done, 0, frames * sizeof(float));
+            }
+        }
+        done += frames;
+        readPosition_ += frames;
+    }
+    if (claimed && workerRunning_)
+    {
+        ::semaphore_signal(workerWake_);
+    }
+}
+
+#pragma mark - worker thread
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::Rewind
+//  ---------------------------------------------------------------------------
+void
+LookAheadRenderer::Rewind(uint64_t position)
+{
+    while (true)
+    {
+        const int64_t   counters = AtomicLoad64(&counters_);
+        const uint32_t  readBlock = ReadBlock(counters);
+        const uint32_t  writeBlock = WriteBlock(counters);
+        //  R may be claimed at any moment, keep it
+        uint32_t    blockNo = static_cast<uint32_t>(position / blockLength_);
+        if (static_cast<int32_t>(blockNo - (readBlock + 1)) < 0)
+        {
+            blockNo = readBlock + 1;
+        }
+        if (static_cast<int32_t>(writeBlock - blockNo) <= 0)
+        {
+            return;     //  not rendered yet
+        }
+        if (AtomicCompareAndSwap64(counters, Pack(readBlock, blockNo), &counters_))
+        {
+            source_->RestoreCheckpoint(blockNo % numberOfBlocks_);
+            return;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::RunWorker
+//  ---------------------------------------------------------------------------
+void
+LookAheadRenderer::RunWorker(void)
+{
+    std::vector<float*> stems(numberOfStems_, static_cast<float*>(NULL));
+    while (true)
+    {
+        AtomicMemoryBarrier();
+        if (workerQuit_)
+        {
+            break;
+        }
+        const int64_t   invalidFrom = AtomicExchange64(&invalidFrom_, kNotInvalidated);
+        if (invalidFrom != kNotInvalidated)
+        {
+            this->Rewind(static_cast<uint64_t>(invalidFrom));
+        }
+
+        const int64_t   counters = AtomicLoad64(&counters_);
+        const uint32_t  writeBlock = WriteBlock(counters);
+        if (static_cast<int32_t>(writeBlock - ReadBlock(counters)) >= numberOfBlocks_ - 1)
+        {
+            ::semaphore_wait(workerWake_);
+            continue;
+        }
+
+        //  a block already missed by the audio thread is rendered all the same to keep the state running
+        const int   slotNo = writeBlock % numberOfBlocks_;
+        for (int stemNo = 0; stemNo < numberOfStems_; ++stemNo)
+        {
+            stems[stemNo] = this->GetStem(slotNo, stemNo);
+        }
+        source_->SaveCheckpoint(slotNo);
+        source_->RenderAhead(&stems[0], static_cast<uint64_t>(writeBlock) * blockLength_, blockLength_);
+
+        while (true)
+        {
+            const int64_t   current = AtomicLoad64(&counters_);
+            if (AtomicCompareAndSwap64(current, Pack(ReadBlock(current), writeBlock + 1), &counters_))
+            {
+                break;
+            }
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      LookAheadRenderer::WorkerThreadEntry                        [static]
+//  ---------------------------------------------------------------------------
+void*
+LookAheadRenderer::WorkerThreadEntry(void* arg)
+{
+    LookAheadRenderer*  renderer = reinterpret_cast<LookAheadRenderer*>(arg);
+    renderer->RunWorker();
+    return NULL;
+}
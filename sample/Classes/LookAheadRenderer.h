@@ -0,0 +1,101 @@
+//
+//  LookAheadRenderer.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+#include <mach/semaphore.h>
+#include "AlignedBuffer.h"
+
+//
+//  content rendered ahead of the audio thread
+//
+class LookAheadSource
+{
+public:
+    virtual ~LookAheadSource(void)  {}
+
+    //  worker thread
+    virtual void    SaveCheckpoint(int slotNo) = 0;     //  state at the start of the block rendered into slotNo
+    virtual void    RestoreCheckpoint(int slotNo) = 0;
+    virtual void    RenderAhead(float* const* stems, uint64_t position, int length) = 0;
+
+    //  audio thread : the block rendered into slotNo starts playing
+    virtual void    BlockClaimed(int /*slotNo*/, uint64_t /*position*/)     {}
+};
+
+//
+//  A worker thread renders fixed size blocks of a LookAheadSource ahead into a ring,
+//  the audio thread only copies them out.
+//
+//  The read (R) and write (W) block counters are packed into one 64-bit word and only
+//  ever changed by CAS : the audio thread increments R when it claims a block, the worker
+//  increments W when it has rendered one, and sets W back to rewind. The block the audio
+//  thread is reading is never written, so the ring holds numberOfBlocks - 1 blocks ahead.
+//
+//  Invalidate() rewinds the worker to the block holding the given position (never the block
+//  about to be read) and re-renders from its checkpoint. A block that is not ready when the
+//  audio thread needs it plays as silence and is counted; the worker still renders it, into a
+//  slot nobody reads, so that the state of the source runs on without a gap.
+//
+class LookAheadRenderer
+{
+public:
+    LookAheadRenderer(LookAheadSource* source, int numberOfStems, int blockLength, int numberOfBlocks);
+    ~LookAheadRenderer(void);
+
+    //  control thread, while the audio thread is not reading
+    bool    Start(void);
+    void    Stop(void);     //  leaves the source in the state of the first unread block
+
+    //  any thread
+    void    Invalidate(uint64_t position);
+    uint32_t    GetUnderrunCount(void) const    { return underrunCount_; }
+    uint64_t    GetPlayedPosition(void);        //  end of the blocks taken by the audio thread, never rendered again
+
+    //  audio thread
+    uint64_t    GetReadPosition(void) const     { return readPosition_; }
+    void    Read(float* const* dest, int length);
+
+private:
+    LookAheadRenderer(const LookAheadRenderer& other);                      //  not implemented
+    const LookAheadRenderer& operator= (const LookAheadRenderer& other);    //  not implemented
+
+    static int64_t  Pack(uint32_t readBlock, uint32_t writeBlock)
+    {
+        return static_cast<int64_t>((static_cast<uint64_t>(readBlock) << 32) | writeBlock);
+    }
+    static uint32_t ReadBlock(int64_t counters)     { return static_cast<uint32_t>(static_cast<uint64_t>(counters) >> 32); }
+    static uint32_t WriteBlock(int64_t counters)    { return static_cast<uint32_t>(counters); }
+
+    float*  GetStem(int slotNo, int stemNo)     { return &stems_[(slotNo * numberOfStems_ + stemNo) * blockLength_]; }
+    bool    Claim(uint32_t blockNo);
+    void    Rewind(uint64_t position);
+    void    RunWorker(void);
+    static void*    WorkerThreadEntry(void* arg);
+
+    LookAheadSource*    source_;
+    const int   numberOfStems_;
+    const int   blockLength_;
+    const int   numberOfBlocks_;
+    AlignedBuffer<float>    stems_;
+    volatile int64_t    counters_;      //  R << 32 | W
+    volatile int64_t    invalidFrom_;   //  kNotInvalidated : none
+    volatile uint32_t   underrunCount_;
+
+    //  audio thread
+    uint64_t    readPosition_;
+    bool        isBlockValid_;
+
+    //  worker
+    pthread_t       workerThread_;
+    bool            workerRunning_;
+    semaphore_t     workerWake_;
+    volatile bool   workerQuit_;
+};
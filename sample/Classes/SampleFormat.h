@@ -0,0 +1,100 @@
+//
+//  SampleFormat.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+//
+//  PCM storage formats of a drum sample.
+//  Read() returns a sample scaled to the signed 24-bit range, SwapByteOrder() converts one
+//  stored sample from the other endianness. int24 samples are kept packed, in host byte order.
+//
+
+//  ---------------------------------------------------------------------------
+//      SampleFormatInt16
+//  ---------------------------------------------------------------------------
+struct SampleFormatInt16
+{
+    typedef int16_t StorageType;
+    enum
+    {
+        kStorageUnits = 1,  //  StorageType per sample
+        kBitsPerSample = 16,
+    };
+
+    static inline int32_t   Read(const StorageType* src)
+    {
+        return static_cast<int32_t>(*src) << 8;
+    }
+    static inline void  SwapByteOrder(StorageType* sample)
+    {
+        const uint16_t  value = static_cast<uint16_t>(*sample);
+        *sample = static_cast<int16_t>((value >> 8) | (value << 8));
+    }
+};
+
+//  ---------------------------------------------------------------------------
+//      SampleFormatInt24
+//  ---------------------------------------------------------------------------
+struct SampleFormatInt24
+{
+    typedef uint8_t StorageType;
+    enum
+    {
+        kStorageUnits = 3,
+        kBitsPerSample = 24,
+    };
+
+    static inline int32_t   Read(const StorageType* src)
+    {
+#if defined(__BIG_ENDIAN__)
+        const uint32_t  value = (static_cast<uint32_t>(src[0]) << 24) | (static_cast<uint32_t>(src[1]) << 16) | (static_cast<uint32_t>(src[2]) << 8);
+#else
+        const uint32_t  value = (static_cast<uint32_t>(src[0]) << 8) | (static_cast<uint32_t>(src[1]) << 16) | (static_cast<uint32_t>(src[2]) << 24);
+#endif
+        return static_cast<int32_t>(value) >> 8;
+    }
+    static inline void  SwapByteOrder(StorageType* sample)
+    {
+        const uint8_t   tmp = sample[0];
+        sample[0] = sample[2];
+        sample[2] = tmp;
+    }
+};
+
+//  ---------------------------------------------------------------------------
+//      SampleFormatFloat32
+//  ---------------------------------------------------------------------------
+struct SampleFormatFloat32
+{
+    typedef float   StorageType;
+    enum
+    {
+        kStorageUnits = 1,
+        kBitsPerSample = 32,
+    };
+
+    static inline int32_t   Read(const StorageType* src)
+    {
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+        const float value = CLIP(*src, -1.0f, 1.0f);
+        return static_cast<int32_t>(value * 0x7FFFFF);
+#undef CLIP
+    }
+    static inline void  SwapByteOrder(StorageType* sample)
+    {
+        uint8_t*    bytes = reinterpret_cast<uint8_t*>(sample);
+        uint8_t     tmp = bytes[0];
+        bytes[0] = bytes[3];
+        bytes[3] = tmp;
+        tmp = bytes[1];
+        bytes[1] = bytes[2];
+        bytes[2] = tmp;
+    }
+};
@@ -0,0 +1,62 @@
+//
+//  Seqlock.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "AtomicOps.h"
+
+//
+//  Value published by one writer that never waits; readers copy it and retry if
+//  a write happened meanwhile (odd sequence : write in progress).
+//
+template <typename T>
+class Seqlock
+{
+public:
+    Seqlock(void) : sequence_(0), value_()
+    {
+    }
+
+    //  the writer thread
+    void    Write(const T& value)
+    {
+        const int32_t   sequence = sequence_;
+        AtomicStore32(&sequence_, sequence + 1);
+        AtomicMemoryBarrier();
+        value_ = value;
+        AtomicMemoryBarrier();
+        AtomicStore32(&sequence_, sequence + 2);
+    }
+
+    //  any thread
+    void    Read(T& value) const
+    {
+        while (true)
+        {
+            const int32_t   sequence = AtomicLoad32(&sequence_);
+            if ((sequence & 1) == 0)
+            {
+                AtomicMemoryBarrier();
+                value = value_;
+                AtomicMemoryBarrier();
+                if (AtomicLoad32(&sequence_) == sequence)
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    Seqlock(const Seqlock& other);                      //  not implemented
+    const Seqlock& operator= (const Seqlock& other);    //  not implemented
+
+    mutable volatile int32_t    sequence_;
+    T   value_;
+};
@@ -11,30 +11,54 @@
 #include "Sequencer.h"
 #include "AudioIO.h"
 #include "ScopedLock.h"
+#include "AtomicOps.h"
 
 //  ---------------------------------------------------------------------------
 //      Sequencer::Sequencer
 //  ---------------------------------------------------------------------------
 Sequencer::Sequencer(float samplingRate) :
 samlingRate_(samplingRate),
+numberOfTracks_(4),
 numberOfSteps_(16), //  16 step seq.
 isRunning_(false),
 currentStep_(0),
 stepFrameLength_(0),
 currentFrame_(0),
 trigger_(false),
-seq_(),
+nextClock_(0),
+latestPattern_(NULL),
+currentPattern_(NULL),
+inUseGeneration_(0),
+patternSwitch_(kPatternSwitch_Step),
+retiredPatterns_(),
+nextGeneration_(0),
+editMutex_(),
+commandQueue_(kMaxPendingCommands),
+commandsMutex_(),
 commands_(),
+commandLog_(),
+savedPatterns_(),
+isCommandLogEnabled_(false),
+position_(0),
 listener_(NULL),
-commandsMutex_()
+timebaseNumer_(1),
+timebaseDenom_(1)
 {
-    const int   kNumberOfTrack  = 4;
-    for (int trackNo = 0; trackNo < kNumberOfTrack; ++trackNo)
+    mach_timebase_info_data_t   timeInfo;
+    if (::mach_timebase_info(&timeInfo) == KERN_SUCCESS)
     {
-        std::vector<bool>   partSeq(numberOfSteps_, false);
-        seq_.push_back(partSeq);
+        timebaseNumer_ = timeInfo.numer;
+        timebaseDenom_ = timeInfo.denom;
     }
+    commands_.reserve(kMaxPendingCommands);
+
+    PatternSnapshot*    empty = new PatternSnapshot;
+    empty->generation = nextGeneration_;
+    empty->steps.assign(numberOfTracks_, std::vector<bool>(numberOfSteps_, false));
+    latestPattern_ = empty;
     this->SetDefault();
+    this->SwitchPattern();
+    this->CollectPatterns();
 }
 
 //  ---------------------------------------------------------------------------
@@ -42,6 +66,104 @@ commandsMutex_()
 //  ---------------------------------------------------------------------------
 Sequencer::~Sequencer(void)
 {
+    //  currentPattern_ is either the latest or a retired one
+    for (size_t index = 0; index < retiredPatterns_.size(); ++index)
+    {
+        delete retiredPatterns_[index];
+    }
+    retiredPatterns_.clear();
+    delete latestPattern_;
+    latestPattern_ = NULL;
+}
+
+#pragma mark - pattern
+//
+//  RCU : the editors copy the latest snapshot, change the copy and publish it with one
+//  pointer store. The audio thread picks the latest one up at a step (or bar) boundary and
+//  publishes the oldest generation it may still use, its own or that of a saved state it may
+//  be rewound to; a retired snapshot older than that generation can not be reached any more
+//  and is freed by the editors.
+//
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::Publish
+//  ---------------------------------------------------------------------------
+//  editMutex_ is locked
+void
+Sequencer::Publish(PatternSnapshot* snapshot)
+{
+    snapshot->generation = ++nextGeneration_;
+    PatternSnapshot*    prev = AtomicExchangePtr(&latestPattern_, snapshot);
+    retiredPatterns_.push_back(prev);
+    this->CollectPatterns();
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::CollectPatterns
+//  ---------------------------------------------------------------------------
+void
+Sequencer::CollectPatterns(void)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    const int32_t   inUse = AtomicLoad32(&inUseGeneration_);
+    std::vector<PatternSnapshot*>::iterator ite = retiredPatterns_.begin();
+    while (ite != retiredPatterns_.end())
+    {
+        if (((*ite)->generation - inUse) < 0)
+        {
+            delete *ite;
+            ite = retiredPatterns_.erase(ite);
+        }
+        else
+        {
+            ++ite;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::SwitchPattern
+//  ---------------------------------------------------------------------------
+//  audio thread
+inline void
+Sequencer::SwitchPattern(void)
+{
+    const PatternSnapshot*  latest = AtomicLoadPtr(&latestPattern_);
+    if (latest != currentPattern_)
+    {
+        currentPattern_ = latest;
+        this->PublishInUseGeneration();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::PublishInUseGeneration
+//  ---------------------------------------------------------------------------
+//  audio thread : the generations of the saved states never decrease, the front one is the oldest
+void
+Sequencer::PublishInUseGeneration(void)
+{
+    int32_t inUse = currentPattern_->generation;
+    if (!savedPatterns_.empty() && ((savedPatterns_.front().generation - inUse) < 0))
+    {
+        inUse = savedPatterns_.front().generation;
+    }
+    AtomicStore32(&inUseGeneration_, inUse);
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::Get
+//  ---------------------------------------------------------------------------
+bool
+Sequencer::Get(int trackNo, int stepNo)
+{
+    ScopedLock<CriticalSection> lock(editMutex_);
+    const Pattern&  steps = latestPattern_->steps;
+    if ((trackNo >= 0) && (trackNo < numberOfTracks_) && (stepNo >= 0) && (stepNo < numberOfSteps_))
+    {
+        return steps[trackNo][stepNo];
+    }
+    return false;
 }
 
 //  ---------------------------------------------------------------------------
@@ -50,14 +172,37 @@ Sequencer::~Sequencer(void)
 void
 Sequencer::Set(int trackNo, int stepNo, bool sw)
 {
-    if ((trackNo >= 0) && (trackNo < static_cast<int>(seq_.size())))
+    if ((trackNo >= 0) && (trackNo < numberOfTracks_) && (stepNo >= 0) && (stepNo < numberOfSteps_))
+    {
+        ScopedLock<CriticalSection> lock(editMutex_);
+        if (latestPattern_->steps[trackNo][stepNo] != sw)
+        {
+            PatternSnapshot*    snapshot = new PatternSnapshot(*latestPattern_);
+            snapshot->steps[trackNo][stepNo] = sw;
+            this->Publish(snapshot);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::SetPattern
+//  ---------------------------------------------------------------------------
+//  tracks / steps beyond the pattern are cleared
+void
+Sequencer::SetPattern(const Pattern& pattern)
+{
+    PatternSnapshot*    snapshot = new PatternSnapshot;
+    snapshot->steps.assign(numberOfTracks_, std::vector<bool>(numberOfSteps_, false));
+    for (int trackNo = 0; trackNo < std::min<int>(numberOfTracks_, pattern.size()); ++trackNo)
     {
-        std::vector<bool>&   track = seq_[trackNo];
-        if ((stepNo >= 0) && (stepNo < static_cast<int>(track.size())))
+        const std::vector<bool>&    track = pattern[trackNo];
+        for (int stepNo = 0; stepNo < std::min<int>(numberOfSteps_, track.size()); ++stepNo)
         {
-            track[stepNo] = sw;
+            snapshot->steps[trackNo][stepNo] = track[stepNo];
         }
     }
+    ScopedLock<CriticalSection> lock(editMutex_);
+    this->Publish(snapshot);
 }
 
 //  ---------------------------------------------------------------------------
@@ -66,13 +211,15 @@ Sequencer::Set(int trackNo, int stepNo, bool sw)
 void
 Sequencer::SetDefault(void)
 {
+    Pattern pattern(numberOfTracks_, std::vector<bool>(numberOfSteps_, false));
     for (int step = 0; step < numberOfSteps_; ++step)
     {
-        this->Set(0, step, ((step % 4) == 0));
-        this->Set(1, step, ((step % 8) == 4));
-        this->Set(2, step, ((step % 2) == 0));
-        this->Set(3, step, true);
+        pattern[0][step] = ((step % 4) == 0);
+        pattern[1][step] = ((step % 8) == 4);
+        pattern[2][step] = ((step % 2) == 0);
+        pattern[3][step] = true;
     }
+    this->SetPattern(pattern);
 }
 
 enum
@@ -85,7 +232,7 @@ enum
 //      Sequencer::ProcessCommand
 //  ---------------------------------------------------------------------------
 inline void
-Sequencer::ProcessCommand(SeqCommandEvent& event)
+Sequencer::ProcessCommand(SeqCommandEvent& event, int offset)
 {
     switch (event.command)
     {
@@ -97,13 +244,17 @@ Sequencer::ProcessCommand(SeqCommandEvent& event)
                 currentFrame_ = 0;
                 stepFrameLength_ = samlingRate_ * 60.0f / tempo / 4;   //  length = 1/16
                 trigger_ = true;
+                nextClock_ = 0;
+                this->SwitchPattern();
                 isRunning_ = true;
+                this->Output(offset, kOutputEvent_Start, 0);
             }
             break;
         case kSeqCommand_Stop:
             if (isRunning_)
             {
                 isRunning_ = false;
+                this->Output(offset, kOutputEvent_Stop, 0);
             }
             break;
         default:
@@ -115,52 +266,51 @@ Sequencer::ProcessCommand(SeqCommandEvent& event)
 //      Sequencer::ProcessCommands
 //  ---------------------------------------------------------------------------
 inline int
-Sequencer::ProcessCommands(AudioIO* io, int offset, int length)
+Sequencer::ProcessCommands(uint64_t hostTime, uint64_t latency, int offset, int length)
 {
-    if (!commands_.empty())
+    SeqCommandEvent newCommand;
+    while (commandQueue_.Pop(newCommand))
+    {
+        this->InsertCommand(newCommand);
+    }
+    if (commands_.empty())
+    {
+        return length;
+    }
+    int result = length;
+    //  commands_ is kept sorted by InsertCommand()
+    while (!commands_.empty())
     {
-        const uint64_t  hostTime = (io != NULL) ? io->GetHostTime() : 0;
-        const uint64_t  latency = (io != NULL) ? io->GetLatency() : 0;
-        mach_timebase_info_data_t timeInfo;
-        ::mach_timebase_info(&timeInfo);
+        const SeqCommandEvent&  event = commands_.front();
+        if (event.hostTime != 0)    //  0 : now
         {
-            ScopedLock<CriticalSection> lock(commandsMutex_);
-            std::sort(commands_.begin(), commands_.end(), Sequencer::SortEventFunctor);
-            for (std::vector<SeqCommandEvent>::iterator ite = commands_.begin(); ite != commands_.end();)
+            if (hostTime == 0)
             {
-                bool    doProcess = false;
-                if (ite->hostTime == 0)    //  now
-                {
-                    doProcess = true;
-                }
-                else if (io != NULL)
-                {
-                    const int64_t   delta = ite->hostTime - hostTime;
-                    const int64_t   deltaNanosec = delta * timeInfo.numer / timeInfo.denom + latency;
-                    const int32_t   sampleOffset = static_cast<int32_t>(static_cast<double>(deltaNanosec) * samlingRate_ / 1000000000);
-                    if (sampleOffset < offset + length)
-                    {
-                        const int   eventFrame = sampleOffset - offset;
-                        if (eventFrame > 0)
-                        {
-                            return eventFrame;
-                        }
-                        doProcess = true;
-                    }
-                }
-                if (doProcess)
-                {
-                    this->ProcessCommand(*ite);
-                    ite = commands_.erase(ite);
-                }
-                else
-                {
-                    ++ite;
-                }
+                break;
+            }
+            const int64_t   delta = event.hostTime - hostTime;
+            const int64_t   deltaNanosec = delta * timebaseNumer_ / timebaseDenom_ + latency;
+            const int32_t   sampleOffset = static_cast<int32_t>(static_cast<double>(deltaNanosec) * samlingRate_ / 1000000000);
+            if (sampleOffset >= offset + length)
+            {
+                break;
+            }
+            const int   eventFrame = sampleOffset - offset;
+            if (eventFrame > 0)
+            {
+                result = eventFrame;
+                break;
             }
         }
+        this->ProcessCommand(commands_.front(), offset);
+        if (isCommandLogEnabled_)
+        {
+            const AppliedCommand    applied = { position_, commands_.front() };
+            commandLog_.push_back(applied);
+        }
+        commands_.erase(commands_.begin());
     }
-    return length;
+    return result;
 }
 
 //  ---------------------------------------------------------------------------
@@ -173,6 +323,7 @@ Sequencer::ProcessTrigger(int offset, int trackNo)
     {
         listener_->NoteOnViaSequencer(offset, trackNo);
     }
+    this->Output(offset, kOutputEvent_Note, trackNo);
 }
 
 //  ---------------------------------------------------------------------------
@@ -185,10 +336,10 @@ Sequencer::ProcessTrigger(int offset)
     {
         if ((currentStep_ >= 0) && (currentStep_ < numberOfSteps_))
         {
-            const int   numOfTrack = seq_.size();
-            for (int trackNo = 0; trackNo < numOfTrack; ++trackNo)
+            const Pattern&  steps = currentPattern_->steps;
+            for (int trackNo = 0; trackNo < numberOfTracks_; ++trackNo)
             {
-                std::vector<bool>&   partSeq = seq_[trackNo];
+                const std::vector<bool>&    partSeq = steps[trackNo];
                 if (partSeq[currentStep_])
                 {
                     this->ProcessTrigger(offset + currentFrame_, trackNo);
@@ -199,6 +350,38 @@ Sequencer::ProcessTrigger(int offset)
     }
 }
 
+//  ---------------------------------------------------------------------------
+//      Sequencer::Output
+//  ---------------------------------------------------------------------------
+inline void
+Sequencer::Output(int frame, int type, int value)
+{
+    if (listener_ != NULL)
+    {
+        listener_->OutputViaSequencer(frame, type, value);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::ProcessClock
+//  ---------------------------------------------------------------------------
+//  clocks of the current step falling into currentFrame_ .. currentFrame_ + length
+inline void
+Sequencer::ProcessClock(int offset, int length)
+{
+    while (nextClock_ < kClocksPerStep)
+    {
+        const float clockFrame = stepFrameLength_ * nextClock_ / kClocksPerStep;
+        if (clockFrame >= currentFrame_ + length)
+        {
+            break;
+        }
+        const int   frame = static_cast<int>(clockFrame - currentFrame_);
+        this->Output(offset + std::max<int>(frame, 0), kOutputEvent_Clock, 0);
+        ++nextClock_;
+    }
+}
+
 //  ---------------------------------------------------------------------------
 //      Sequencer::ProcessSequence
 //  ---------------------------------------------------------------------------
@@ -211,6 +394,7 @@ Sequencer::ProcessSequence(int offset, int length)
     {
         const int   processedLen = std::min<int>(rest, std::max<int>(stepFrameLength_ - currentFrame_, 1));
         this->ProcessTrigger(startFrame);
+        this->ProcessClock(startFrame, processedLen);
         currentFrame_ += processedLen;
         rest -= processedLen;
         startFrame += processedLen;
@@ -222,7 +406,12 @@ Sequencer::ProcessSequence(int offset, int length)
             {
                 currentStep_ = 0;
             }
+            if ((patternSwitch_ == kPatternSwitch_Step) || (currentStep_ == 0))
+            {
+                this->SwitchPattern();
+            }
             trigger_ = true;
+            nextClock_ = 0;
         }
     }
 }
@@ -233,14 +422,134 @@ Sequencer::ProcessSequence(int offset, int length)
 int
 Sequencer::Process(AudioIO* io, int offset, int length)
 {
-    const int   result = this->ProcessCommands(io, offset, length);
+    const uint64_t  hostTime = (io != NULL) ? io->GetHostTime() : 0;
+    const uint64_t  latency = (io != NULL) ? io->GetLatency() : 0;
+    return this->Process(hostTime, latency, offset, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::Process
+//  ---------------------------------------------------------------------------
+int
+Sequencer::Process(uint64_t hostTime, uint64_t latency, int offset, int length)
+{
+    const int   result = this->ProcessCommands(hostTime, latency, offset, length);
+    if (!isRunning_)
+    {
+        this->SwitchPattern();  //  no boundary to wait for
+    }
     if (isRunning_ && (result > 0))
     {
         this->ProcessSequence(offset, result);
     }
+    position_ += result;
     return result;
 }
 
+#pragma mark -
+//  ---------------------------------------------------------------------------
+//      Sequencer::SetCommandLogEnabled
+//  ---------------------------------------------------------------------------
+void
+Sequencer::SetCommandLogEnabled(bool enable)
+{
+    isCommandLogEnabled_ = enable;
+    if (!enable)
+    {
+        commandLog_.clear();
+        savedPatterns_.clear();
+        this->PublishInUseGeneration();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::DiscardCommandLog
+//  ---------------------------------------------------------------------------
+void
+Sequencer::DiscardCommandLog(uint64_t position)
+{
+    std::vector<AppliedCommand>::iterator   ite = commandLog_.begin();
+    while ((ite != commandLog_.end()) && (ite->position < position))
+    {
+        ++ite;
+    }
+    commandLog_.erase(commandLog_.begin(), ite);
+
+    std::vector<SavedPattern>::iterator saved = savedPatterns_.begin();
+    while ((saved != savedPatterns_.end()) && (saved->position < position))
+    {
+        ++saved;
+    }
+    if (saved != savedPatterns_.begin())
+    {
+        savedPatterns_.erase(savedPatterns_.begin(), saved);
+        this->PublishInUseGeneration();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::SaveState
+//  ---------------------------------------------------------------------------
+void
+Sequencer::SaveState(State& state)
+{
+    state.position = position_;
+    state.isRunning = isRunning_;
+    state.currentStep = currentStep_;
+    state.stepFrameLength = stepFrameLength_;
+    state.currentFrame = currentFrame_;
+    state.trigger = trigger_;
+    state.nextClock = nextClock_;
+    state.pattern = currentPattern_;
+    state.patternGeneration = currentPattern_->generation;
+    if (isCommandLogEnabled_)
+    {
+        //  no need to publish, currentPattern_ is at least as old
+        const SavedPattern  saved = { position_, currentPattern_->generation };
+        savedPatterns_.push_back(saved);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::RestoreState
+//  ---------------------------------------------------------------------------
+void
+Sequencer::RestoreState(const State& state)
+{
+    position_ = state.position;
+    isRunning_ = state.isRunning;
+    currentStep_ = state.currentStep;
+    stepFrameLength_ = state.stepFrameLength;
+    currentFrame_ = state.currentFrame;
+    trigger_ = state.trigger;
+    nextClock_ = state.nextClock;
+
+    //  the states saved after this one are saved again when rendered again, this one is in use
+    std::vector<SavedPattern>::iterator saved = savedPatterns_.end();
+    while ((saved != savedPatterns_.begin()) && ((saved - 1)->position >= state.position))
+    {
+        --saved;
+    }
+    savedPatterns_.erase(saved, savedPatterns_.end());
+    currentPattern_ = state.pattern;
+    this->PublishInUseGeneration();
+
+    //  the log is in position order
+    std::vector<AppliedCommand>::iterator   ite = commandLog_.end();
+    while ((ite != commandLog_.begin()) && ((ite - 1)->position >= state.position))
+    {
+        --ite;
+    }
+    if (ite != commandLog_.end())
+    {
+        for (std::vector<AppliedCommand>::iterator redo = ite; redo != commandLog_.end(); ++redo)
+        {
+            this->InsertCommand(redo->event);
+        }
+        commandLog_.erase(ite, commandLog_.end());
+    }
+}
+
 #pragma mark -
 //  ---------------------------------------------------------------------------
 //      Sequencer::AddCommand
@@ -248,9 +557,20 @@ Sequencer::Process(AudioIO* io, int offset, int length)
 void
 Sequencer::AddCommand(uint64_t hostTime, int cmd, float param0)
 {
+    //  the lock only orders the control threads; the queue is single producer
     ScopedLock<CriticalSection> lock(commandsMutex_);
     const SeqCommandEvent   event = { hostTime, cmd, param0 };
-    commands_.push_back(event);
+    commandQueue_.Push(event);  //  full only while the audio has been stopped for kMaxPendingCommands commands
+}
+
+//  ---------------------------------------------------------------------------
+//      Sequencer::InsertCommand
+//  ---------------------------------------------------------------------------
+//  audio thread : keep the pending commands sorted so that only the front is looked at
+inline void
+Sequencer::InsertCommand(const SeqCommandEvent& event)
+{
+    commands_.insert(std::upper_bound(commands_.begin(), commands_.end(), event, Sequencer::SortEventFunctor), event);
 }
 
 //  ---------------------------------------------------------------------------
@@ -8,35 +8,95 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <vector>
 #include "CriticalSection.h"
+#include "EventOutput.h"
+#include "SpscQueue.h"
 
 class SequencerListener
 {
 public:
     virtual ~SequencerListener(void)    {}
     virtual void    NoteOnViaSequencer(int frame, int partNo) = 0;
+    //  clock / start / stop / note for the output event stream (kOutputEvent_xxx)
+    virtual void    OutputViaSequencer(int /*frame*/, int /*type*/, int /*value*/)  {}
 };
 
 class Sequencer
 {
 public:
+    struct PatternSnapshot;
+
+    //  playback state, for rendering ahead and rewinding
+    typedef struct {
+        uint64_t    position;       //  frames processed
+        bool        isRunning;
+        int         currentStep;
+        float       stepFrameLength;
+        float       currentFrame;
+        bool        trigger;
+        int         nextClock;
+        const PatternSnapshot*  pattern;    //  kept alive while the command log is enabled
+        int32_t     patternGeneration;
+    } State;
+
+    typedef std::vector< std::vector<bool> >    Pattern;    //  [trackNo][stepNo]
+
+    enum
+    {
+        kClocksPerStep = 6,         //  24 PPQN, a step is a 16th note
+    };
+
+    enum
+    {
+        kPatternSwitch_Step = 0,    //  an edit takes effect at the next step
+        kPatternSwitch_Bar,         //  at the next bar (step 0)
+    };
+
     Sequencer(float sampleRate);
     ~Sequencer(void);
 
+    //  pattern edit (any thread but the audio thread, never blocks it)
+    int     GetNumberOfTracks(void) const   { return numberOfTracks_; }
+    int     GetNumberOfSteps(void) const    { return numberOfSteps_; }
+    bool    Get(int trackNo, int stepNo);
+    void    Set(int trackNo, int stepNo, bool sw);
+    void    SetPattern(const Pattern& pattern);
+    void    SetPatternSwitch(int mode)      { patternSwitch_ = mode; }
+    void    CollectPatterns(void);          //  free the snapshots the audio thread is done with
+
     void    SetListener(SequencerListener* listener)    { listener_ = listener; }
 
+    //  any thread but the audio thread, never blocks it
     void    Start(uint64_t hostTime, float tempo);
     void    Stop(uint64_t hostTime);
 
     int     Process(class AudioIO* io, int offset, int length);
+    //  hostTime : host time of the frame at offset, 0 if unknown (only commands for 'now' are processed)
+    int     Process(uint64_t hostTime, uint64_t latency, int offset, int length);
+
+    //  the commands applied after a saved state are queued again when it is restored, and the
+    //  pattern of a saved state is not freed until the state is discarded
+    void    SetCommandLogEnabled(bool enable);
+    void    DiscardCommandLog(uint64_t position);   //  forget the commands and states before position
+    uint64_t    GetPosition(void) const     { return position_; }
+    void    SaveState(State& state);
+    void    RestoreState(const State& state);
 
 private:
     Sequencer(const Sequencer& other);                      //  not implemented
     const Sequencer& operator= (const Sequencer& other);    //  not implemented
 
     void    SetDefault(void);
-    void    Set(int trackNo, int stepNo, bool sw);
+    void    Publish(PatternSnapshot* snapshot);
+    void    SwitchPattern(void);
+    void    PublishInUseGeneration(void);
+
+    enum
+    {
+        kMaxPendingCommands = 64,
+    };
 
     typedef struct {
         uint64_t    hostTime;
@@ -48,22 +108,55 @@ private:
         return (left.hostTime == right.hostTime) ? (left.command < right.command) : (left.hostTime < right.hostTime);
     }
 
-    int     ProcessCommands(class AudioIO* io, int offset, int length);
-    void    ProcessCommand(SeqCommandEvent& event);
+    int     ProcessCommands(uint64_t hostTime, uint64_t latency, int offset, int length);
+    void    ProcessCommand(SeqCommandEvent& event, int offset);
     void    ProcessTrigger(int offset, int trackNo);
     void    ProcessTrigger(int offset);
+    void    ProcessClock(int offset, int length);
+    void    Output(int frame, int type, int value);
     void    ProcessSequence(int offset, int length);
     void    AddCommand(uint64_t hostTime, int cmd, float param0);
+    void    InsertCommand(const SeqCommandEvent& event);
 
     const float samlingRate_;
+    const int   numberOfTracks_;
     const int   numberOfSteps_;
     bool    isRunning_;
     int     currentStep_;
     float   stepFrameLength_;
     float   currentFrame_;
     bool    trigger_;
-    std::vector< std::vector<bool> >   seq_;
-    std::vector<SeqCommandEvent>   commands_;
+    int     nextClock_;         //  clock of the current step to be sent next
+    PatternSnapshot* volatile   latestPattern_;     //  published by the editors
+    const PatternSnapshot*      currentPattern_;    //  owned by the audio thread
+    volatile int32_t    inUseGeneration_;           //  oldest of currentPattern_ and the saved states
+    volatile int32_t    patternSwitch_;
+    std::vector<PatternSnapshot*>   retiredPatterns_;
+    int32_t     nextGeneration_;
+    CriticalSection     editMutex_;
+    SpscQueue<SeqCommandEvent>      commandQueue_;      //  control threads -> audio thread
+    CriticalSection     commandsMutex_;                 //  between the control threads only
+    std::vector<SeqCommandEvent>   commands_;           //  sorted, owned by the audio thread
+    typedef struct {
+        uint64_t        position;
+        SeqCommandEvent event;
+    } AppliedCommand;
+    std::vector<AppliedCommand>    commandLog_;
+    typedef struct {
+        uint64_t    position;
+        int32_t     generation;
+    } SavedPattern;
+    std::vector<SavedPattern>   savedPatterns_;     //  patterns of the saved states, in position order
+    bool    isCommandLogEnabled_;
+    uint64_t    position_;
     SequencerListener*  listener_;
-    CriticalSection     commandsMutex_;
+    uint32_t    timebaseNumer_;     //  mach_timebase_info, queried once
+    uint32_t    timebaseDenom_;
+};
+
+//  immutable once published
+struct Sequencer::PatternSnapshot
+{
+    int32_t     generation;
+    Pattern     steps;
 };
@@ -0,0 +1,176 @@
+//
+//  SimdTypes.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+//
+//  4-lane float vector of the compiler (NEON q register on ARM, SSE on x86).
+//  Arithmetic operators work lane-wise; a dereferenced SimdFloat4* must be 16-byte aligned,
+//  use SimdLoadUnaligned / SimdStoreUnaligned otherwise.
+//
+typedef float   SimdFloat4 __attribute__((vector_size(16)));
+
+enum
+{
+    kSimdWidth = 4,
+};
+
+//  ---------------------------------------------------------------------------
+//      SimdSplat
+//  ---------------------------------------------------------------------------
+static inline SimdFloat4
+SimdSplat(float value)
+{
+    const SimdFloat4    result = { value, value, value, value };
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdMax
+//  ---------------------------------------------------------------------------
+static inline SimdFloat4
+SimdMax(SimdFloat4 a, SimdFloat4 b)
+{
+    SimdFloat4  result;
+    for (int lane = 0; lane < kSimdWidth; ++lane)
+    {
+        result[lane] = (a[lane] > b[lane]) ? a[lane] : b[lane];
+    }
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdAbs
+//  ---------------------------------------------------------------------------
+static inline SimdFloat4
+SimdAbs(SimdFloat4 a)
+{
+    return SimdMax(a, -a);
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdSwapPairs
+//  ---------------------------------------------------------------------------
+//  { a1, a0, a3, a2 }
+static inline SimdFloat4
+SimdSwapPairs(SimdFloat4 a)
+{
+#if defined(__clang__)
+    return __builtin_shufflevector(a, a, 1, 0, 3, 2);
+#else
+    typedef int32_t SimdMask4 __attribute__((vector_size(16)));
+    const SimdMask4 mask = { 1, 0, 3, 2 };
+    return __builtin_shuffle(a, mask);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdSwapHalves
+//  ---------------------------------------------------------------------------
+//  { a2, a3, a0, a1 }
+static inline SimdFloat4
+SimdSwapHalves(SimdFloat4 a)
+{
+#if defined(__clang__)
+    return __builtin_shufflevector(a, a, 2, 3, 0, 1);
+#else
+    typedef int32_t SimdMask4 __attribute__((vector_size(16)));
+    const SimdMask4 mask = { 2, 3, 0, 1 };
+    return __builtin_shuffle(a, mask);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdTranspose4
+//  ---------------------------------------------------------------------------
+//  rows <-> columns of the 4x4 matrix { a, b, c, d }
+static inline void
+SimdTranspose4(SimdFloat4& a, SimdFloat4& b, SimdFloat4& c, SimdFloat4& d)
+{
+#if defined(__clang__)
+    const SimdFloat4    ab01 = __builtin_shufflevector(a, b, 0, 4, 1, 5);  //  { a0, b0, a1, b1 }
+    const SimdFloat4    cd01 = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    const SimdFloat4    ab23 = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    const SimdFloat4    cd23 = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+    a = __builtin_shufflevector(ab01, cd01, 0, 1, 4, 5);
+    b = __builtin_shufflevector(ab01, cd01, 2, 3, 6, 7);
+    c = __builtin_shufflevector(ab23, cd23, 0, 1, 4, 5);
+    d = __builtin_shufflevector(ab23, cd23, 2, 3, 6, 7);
+#else
+    typedef int32_t SimdMask4 __attribute__((vector_size(16)));
+    const SimdMask4 low = { 0, 4, 1, 5 };
+    const SimdMask4 high = { 2, 6, 3, 7 };
+    const SimdMask4 lowHalves = { 0, 1, 4, 5 };
+    const SimdMask4 highHalves = { 2, 3, 6, 7 };
+    const SimdFloat4    ab01 = __builtin_shuffle(a, b, low);
+    const SimdFloat4    cd01 = __builtin_shuffle(c, d, low);
+    const SimdFloat4    ab23 = __builtin_shuffle(a, b, high);
+    const SimdFloat4    cd23 = __builtin_shuffle(c, d, high);
+    a = __builtin_shuffle(ab01, cd01, lowHalves);
+    b = __builtin_shuffle(ab01, cd01, highHalves);
+    c = __builtin_shuffle(ab23, cd23, lowHalves);
+    d = __builtin_shuffle(ab23, cd23, highHalves);
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdLoadUnaligned
+//  ---------------------------------------------------------------------------
+static inline SimdFloat4
+SimdLoadUnaligned(const float* src)
+{
+    SimdFloat4  result;
+    ::memcpy(&result, src, sizeof(result));
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdStoreUnaligned
+//  ---------------------------------------------------------------------------
+static inline void
+SimdStoreUnaligned(float* dest, SimdFloat4 value)
+{
+    ::memcpy(dest, &value, sizeof(value));
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdHorizontalMax
+//  ---------------------------------------------------------------------------
+static inline float
+SimdHorizontalMax(SimdFloat4 a)
+{
+    const float m01 = (a[0] > a[1]) ? a[0] : a[1];
+    const float m23 = (a[2] > a[3]) ? a[2] : a[3];
+    return (m01 > m23) ? m01 : m23;
+}
+
+//  ---------------------------------------------------------------------------
+//      SimdPeak
+//  ---------------------------------------------------------------------------
+//  max |x| of a 16-byte aligned buffer
+static inline float
+SimdPeak(const float* src, int length)
+{
+    SimdFloat4  peak = SimdSplat(0.0f);
+    const SimdFloat4*   vec = reinterpret_cast<const SimdFloat4*>(src);
+    const int   numOfVectors = length / kSimdWidth;
+    for (int index = 0; index < numOfVectors; ++index)
+    {
+        peak = SimdMax(peak, SimdAbs(vec[index]));
+    }
+    float   result = SimdHorizontalMax(peak);
+    for (int index = numOfVectors * kSimdWidth; index < length; ++index)
+    {
+        const float absValue = (src[index] < 0.0f) ? -src[index] : src[index];
+        result = (absValue > result) ? absValue : result;
+    }
+    return result;
+}
@@ -0,0 +1,209 @@
+//
+//  SpectrumAnalyzer.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <time.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "SpectrumAnalyzer.h"
+
+enum
+{
+    kTapQueueBlocks = 256,                  //  ~370msec at 44.1kHz
+    kAnalyzerIntervalNanoSec = 33000000,    //  ~30 spectra per sec.
+    kLog2FFTLength = 11,
+};
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::SpectrumAnalyzer
+//  ---------------------------------------------------------------------------
+SpectrumAnalyzer::SpectrumAnalyzer(float samplingRate) :
+samplingRate_(samplingRate),
+tapGeneration_(0),
+tapQueue_(kTapQueueBlocks),
+tapBlock_(),
+tapLength_(0),
+history_(kFFTLength, 0.0f),
+window_(kFFTLength, 0.0f),
+windowed_(kFFTLength, 0.0f),
+real_(kNumberOfBins, 0.0f),
+imag_(kNumberOfBins, 0.0f),
+fftSetup_(::vDSP_create_fftsetup(kLog2FFTLength, kFFTRadix2)),
+spectrum_(),
+published_(),
+analyzerThread_(),
+analyzerRunning_(false),
+analyzerQuit_(false)
+{
+    for (int index = 0; index < kFFTLength; ++index)
+    {
+        window_[index] = 0.5f - 0.5f * ::cosf(2.0f * static_cast<float>(M_PI) * index / kFFTLength);    //  Hann
+    }
+    this->Clear();
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::~SpectrumAnalyzer
+//  ---------------------------------------------------------------------------
+SpectrumAnalyzer::~SpectrumAnalyzer(void)
+{
+    this->Stop();
+    if (fftSetup_ != NULL)
+    {
+        ::vDSP_destroy_fftsetup(fftSetup_);
+        fftSetup_ = NULL;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::Start
+//  ---------------------------------------------------------------------------
+bool
+SpectrumAnalyzer::Start(void)
+{
+    if (!analyzerRunning_ && (fftSetup_ != NULL))
+    {
+        //  the blocks of the previous run still queued, and the one the audio thread was
+        //  filling, are of an older generation and dropped
+        AtomicStore32(&tapGeneration_, tapGeneration_ + 1);
+        this->Clear();
+        analyzerQuit_ = false;
+        analyzerRunning_ = (::pthread_create(&analyzerThread_, NULL, SpectrumAnalyzer::AnalyzerThreadEntry, this) == 0);
+    }
+    return analyzerRunning_;
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::Stop
+//  ---------------------------------------------------------------------------
+void
+SpectrumAnalyzer::Stop(void)
+{
+    if (analyzerRunning_)
+    {
+        analyzerRunning_ = false;
+        analyzerQuit_ = true;
+        AtomicMemoryBarrier();
+        ::pthread_join(analyzerThread_, NULL);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::Tap
+//  ---------------------------------------------------------------------------
+void
+SpectrumAnalyzer::Tap(const float* left, const float* right, int length)
+{
+    if (!analyzerRunning_)
+    {
+        return;
+    }
+    const int32_t   generation = AtomicLoad32(&tapGeneration_);
+    if (tapBlock_.generation != generation)
+    {
+        tapBlock_.generation = generation;
+        tapLength_ = 0;
+    }
+    for (int frame = 0; frame < length; ++frame)
+    {
+        tapBlock_.samples[tapLength_] = 0.5f * (left[frame] + right[frame]);
+        if (++tapLength_ == kTapBlockLength)
+        {
+            tapQueue_.Push(tapBlock_);  //  dropped if the analyzer is behind
+            tapLength_ = 0;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::Clear
+//  ---------------------------------------------------------------------------
+//  while the analyzer thread is not running
+void
+SpectrumAnalyzer::Clear(void)
+{
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    for (int binNo = 0; binNo < kNumberOfBins; ++binNo)
+    {
+        spectrum_.magnitude[binNo] = -120.0f;
+    }
+    published_.Write(spectrum_);
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::Analyze
+//  ---------------------------------------------------------------------------
+void
+SpectrumAnalyzer::Analyze(void)
+{
+    const int32_t   generation = AtomicLoad32(&tapGeneration_);
+    bool    isUpdated = false;
+    TapBlock    block;
+    while (tapQueue_.Pop(block))
+    {
+        if (block.generation != generation)
+        {
+            continue;
+        }
+        ::memmove(&history_[0], &history_[kTapBlockLength], (kFFTLength - kTapBlockLength) * sizeof(float));
+        ::memcpy(&history_[kFFTLength - kTapBlockLength], block.samples, kTapBlockLength * sizeof(float));
+        isUpdated = true;
+    }
+    if (!isUpdated)
+    {
+        return;
+    }
+
+    ::vDSP_vmul(&history_[0], 1, &window_[0], 1, &windowed_[0], 1, kFFTLength);
+    DSPSplitComplex split = { &real_[0], &imag_[0] };
+    ::vDSP_ctoz(reinterpret_cast<const DSPComplex*>(&windowed_[0]), 2, &split, 1, kNumberOfBins);
+    ::vDSP_fft_zrip(fftSetup_, &split, 1, kLog2FFTLength, FFT_FORWARD);
+    split.imagp[0] = 0.0f;  //  packed Nyquist, not shown
+    ::vDSP_zvmags(&split, 1, spectrum_.magnitude, 1, kNumberOfBins);
+
+    //  zrip returns 2x the DFT; a full scale sine through the Hann window peaks at N/4
+    const float scale = 1.0f / (kFFTLength * kFFTLength / 4.0f);
+    ::vDSP_vsmul(spectrum_.magnitude, 1, &scale, spectrum_.magnitude, 1, kNumberOfBins);
+    for (int binNo = 0; binNo < kNumberOfBins; ++binNo)
+    {
+        spectrum_.magnitude[binNo] += 1.0e-12f;     //  floor at -120dB
+    }
+    const float reference = 1.0f;
+    ::vDSP_vdbcon(spectrum_.magnitude, 1, &reference, spectrum_.magnitude, 1, kNumberOfBins, 0);
+    published_.Write(spectrum_);
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::RunAnalyzer
+//  ---------------------------------------------------------------------------
+void
+SpectrumAnalyzer::RunAnalyzer(void)
+{
+    while (true)
+    {
+        AtomicMemoryBarrier();
+        if (analyzerQuit_)
+        {
+            break;
+        }
+        this->Analyze();
+        struct timespec interval = { 0, kAnalyzerIntervalNanoSec };
+        ::nanosleep(&interval, NULL);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      SpectrumAnalyzer::AnalyzerThreadEntry                       [static]
+//  ---------------------------------------------------------------------------
+void*
+SpectrumAnalyzer::AnalyzerThreadEntry(void* arg)
+{
+    SpectrumAnalyzer*   analyzer = reinterpret_cast<SpectrumAnalyzer*>(arg);
+    analyzer->RunAnalyzer();
+    return NULL;
+}
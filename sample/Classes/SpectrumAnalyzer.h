@@ -0,0 +1,89 @@
+//
+//  SpectrumAnalyzer.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+#include <vector>
+#include <Accelerate/Accelerate.h>
+#include "SpscQueue.h"
+#include "Seqlock.h"
+
+//
+//  The audio thread taps the output, mixed to mono, into a lock-free ring; an
+//  analyzer thread runs a windowed FFT over the latest kFFTLength samples and
+//  publishes the magnitudes for the UI. Not decimated : the full band up to
+//  Nyquist, nothing folded back, 21.5 Hz bins at 44.1kHz.
+//
+class SpectrumAnalyzer
+{
+public:
+    enum
+    {
+        kFFTLength = 2048,
+        kNumberOfBins = kFFTLength / 2,
+        kTapBlockLength = 64,       //  samples per ring entry
+    };
+
+    typedef struct {
+        float   magnitude[kNumberOfBins];   //  dB relative to a full scale sine
+    } Spectrum;
+
+    SpectrumAnalyzer(float samplingRate);
+    ~SpectrumAnalyzer(void);
+
+    //  control thread; Start() begins from silence, nothing tapped before is analyzed
+    bool    Start(void);
+    void    Stop(void);
+    bool    IsRunning(void) const   { return analyzerRunning_; }
+
+    //  audio thread; ignored while stopped
+    void    Tap(const float* left, const float* right, int length);
+
+    //  any thread
+    void    Read(Spectrum& spectrum) const  { published_.Read(spectrum); }
+    float   GetBinWidth(void) const         { return samplingRate_ / kFFTLength; }
+
+private:
+    SpectrumAnalyzer(const SpectrumAnalyzer& other);                        //  not implemented
+    const SpectrumAnalyzer& operator= (const SpectrumAnalyzer& other);      //  not implemented
+
+    typedef struct {
+        int32_t generation;         //  tapGeneration_ when the block was begun
+        float   samples[kTapBlockLength];
+    } TapBlock;
+
+    void    Clear(void);
+    void    Analyze(void);
+    void    RunAnalyzer(void);
+    static void*    AnalyzerThreadEntry(void* arg);
+
+    const float samplingRate_;
+
+    volatile int32_t    tapGeneration_;     //  advanced by Start()
+
+    //  audio thread
+    SpscQueue<TapBlock> tapQueue_;
+    TapBlock    tapBlock_;
+    int         tapLength_;
+
+    //  analyzer thread
+    std::vector<float>  history_;   //  latest kFFTLength samples
+    std::vector<float>  window_;
+    std::vector<float>  windowed_;
+    std::vector<float>  real_;
+    std::vector<float>  imag_;
+    FFTSetup    fftSetup_;
+    Spectrum    spectrum_;
+    Seqlock<Spectrum>   published_;
+
+    pthread_t       analyzerThread_;
+    volatile bool   analyzerRunning_;
+    volatile bool   analyzerQuit_;
+};
@@ -0,0 +1,71 @@
+//
+//  SpscQueue.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "AtomicOps.h"
+
+//
+//  bounded lock-free queue for one producer thread and one consumer thread
+//
+template <typename T>
+class SpscQueue
+{
+public:
+    SpscQueue(int capacity) : buffer_(RoundUpToPowerOfTwo(capacity)), mask_(static_cast<int32_t>(buffer_.size()) - 1), head_(0), tail_(0)
+    {
+    }
+
+    //  producer; false when full
+    bool    Push(const T& item)
+    {
+        const int32_t   tail = tail_;
+        const uint32_t  used = static_cast<uint32_t>(tail) - static_cast<uint32_t>(AtomicLoad32(&head_));
+        if (used >= buffer_.size())
+        {
+            return false;
+        }
+        buffer_[tail & mask_] = item;
+        AtomicStore32(&tail_, static_cast<int32_t>(static_cast<uint32_t>(tail) + 1));
+        return true;
+    }
+
+    //  consumer; false when empty
+    bool    Pop(T& item)
+    {
+        const int32_t   head = head_;
+        if (head == AtomicLoad32(&tail_))
+        {
+            return false;
+        }
+        item = buffer_[head & mask_];
+        AtomicStore32(&head_, static_cast<int32_t>(static_cast<uint32_t>(head) + 1));
+        return true;
+    }
+
+private:
+    SpscQueue(const SpscQueue& other);                      //  not implemented
+    const SpscQueue& operator= (const SpscQueue& other);    //  not implemented
+
+    static size_t   RoundUpToPowerOfTwo(int value)
+    {
+        size_t  size = 2;
+        while (static_cast<int>(size) < value)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    std::vector<T>  buffer_;
+    const int32_t   mask_;
+    volatile int32_t    head_;  //  written by the consumer
+    volatile int32_t    tail_;  //  written by the producer
+};
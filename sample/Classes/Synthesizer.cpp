@@ -6,20 +6,61 @@
 //  Copyright 2011 KORG INC. All rights reserved.
 //
 
+#include <mach/mach_time.h>
+#include <math.h>
 #include <algorithm>
 #include "Synthesizer.h"
 #include "Sequencer.h"
 #include "DrumOscillator.h"
+#include "VoiceFilterBank.h"
+#include "EffectsBus.h"
+#include "AtomicOps.h"
+#include "LevelMeter.h"
+#include "SpectrumAnalyzer.h"
+
+enum
+{
+    kRenderBlockLength = 256,   //  frames rendered through the voice lanes at once
+    kLookAheadBlockLength = 64,
+    kLookAheadBlocks = 32,      //  ~46ms ahead at 44.1kHz
+};
 
 //  ---------------------------------------------------------------------------
 //      Synthesizer::Synthesizer
 //  ---------------------------------------------------------------------------
-Synthesizer::Synthesizer(float samplingRate) :
+Synthesizer::Synthesizer(float samplingRate, bool compressSamples) :
 samlingRate_(samplingRate),
 seq_(new Sequencer(samlingRate_)),
 seqEvents_(),
-oscillators_()
+oscillators_(),
+firstLanes_(),
+voiceAudible_(),
+numberOfLanes_(0),
+filterBank_(new VoiceFilterBank(samlingRate_)),
+laneBuffer_(kRenderBlockLength * VoiceFilterBank::kMaxLanes),
+effectsBus_(new EffectsBus(samlingRate_, kRenderBlockLength)),
+sendLevels_(),
+lookAhead_(NULL),
+checkpoints_(NULL),
+lookAheadBase_(0),
+clockOrigin_(0),
+clockLatency_(0),
+timebaseNumer_(1),
+timebaseDenom_(1),
+eventOutput_(NULL),
+laneMeter_(NULL),
+masterMeter_(new LevelMeter(samlingRate_, 2)),
+spectrum_(new SpectrumAnalyzer(samlingRate_)),
+renderHostTime_(0),
+renderSlotNo_(0)
 {
+    mach_timebase_info_data_t   timeInfo;
+    if (::mach_timebase_info(&timeInfo) == KERN_SUCCESS)
+    {
+        timebaseNumer_ = timeInfo.numer;
+        timebaseDenom_ = timeInfo.denom;
+    }
+
     seqEvents_.reserve(100);
 
     const int   kNumberOfOscillator  = 4;
@@ -27,11 +68,23 @@ oscillators_()
     for (int oscNo = 0; oscNo < kNumberOfOscillator; ++oscNo)
     {
         DrumOscillator* osc = new DrumOscillator(samlingRate_);
-        osc->LoadAudioFileInResourceFolder(wavFile[oscNo]);
+        osc->LoadAudioFileInResourceFolder(wavFile[oscNo], compressSamples);
         osc->SetPanpot(64);
+        const int   numOfChannels = osc->GetNumberOfChannels();
+        if (numberOfLanes_ + numOfChannels > VoiceFilterBank::kMaxLanes)
+        {
+            delete osc;
+            break;
+        }
         oscillators_.push_back(osc);
+        firstLanes_.push_back(numberOfLanes_);
+        numberOfLanes_ += numOfChannels;
     }
 
+    voiceAudible_.resize(oscillators_.size(), false);
+    sendLevels_.resize(oscillators_.size() * EffectsBus::kNumberOfSends, 0.0f);
+    laneMeter_ = new LevelMeter(samlingRate_, numberOfLanes_);
+
     seq_->SetListener(this);
 }
 
@@ -40,12 +93,29 @@ oscillators_()
 //  ---------------------------------------------------------------------------
 Synthesizer::~Synthesizer(void)
 {
+    this->SetLookAheadMode(false);
+
     for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
     {
         delete oscillators_[oscNo];
     }
     oscillators_.clear();
 
+    delete filterBank_;
+    filterBank_ = NULL;
+
+    delete effectsBus_;
+    effectsBus_ = NULL;
+
+    delete spectrum_;
+    spectrum_ = NULL;
+
+    delete masterMeter_;
+    masterMeter_ = NULL;
+
+    delete laneMeter_;
+    laneMeter_ = NULL;
+
     delete seq_;
     seq_ = NULL;
 }
@@ -82,7 +152,12 @@ Synthesizer::DecodeSeqEvent(const SequencerEvent* event)
                 const int   oscNo = event->value0;
                 if ((oscNo >= 0) && (oscNo < static_cast<int>(oscillators_.size())))
                 {
-                    oscillators_[oscNo]->TriggerOn();
+                    DrumOscillator* osc = oscillators_[oscNo];
+                    osc->TriggerOn();
+                    for (int ch = 0; ch < osc->GetNumberOfChannels(); ++ch)
+                    {
+                        filterBank_->Trigger(firstLanes_[oscNo] + ch);
+                    }
                 }
             }
             break;
@@ -91,39 +166,269 @@ Synthesizer::DecodeSeqEvent(const SequencerEvent* event)
     }
 }
 
+//  ---------------------------------------------------------------------------
+//      Synthesizer::RenderVoices
+//  ---------------------------------------------------------------------------
+//  oscillators -> lanes -> filter / envelope.
+//  Only the lane groups of audible voices are cleared; an idle voice has its filter state
+//  zeroed, so its lanes stay exactly silent without being touched.
+inline void
+Synthesizer::RenderVoices(int length)
+{
+    enum
+    {
+        kNumberOfGroups = VoiceFilterBank::kNumberOfGroups,
+    };
+    bool    groupUsed[kNumberOfGroups] = { false };
+    for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
+    {
+        const DrumOscillator*   osc = oscillators_[oscNo];
+        const int   firstLane = firstLanes_[oscNo];
+        const int   numOfChannels = osc->GetNumberOfChannels();
+        bool    audible = osc->IsActive();
+        for (int ch = 0; ch < numOfChannels; ++ch)
+        {
+            audible = audible || filterBank_->IsRinging(firstLane + ch);
+        }
+        if (audible || voiceAudible_[oscNo])
+        {
+            //  also once after going idle, for the last output of the filter
+            groupUsed[firstLane / kSimdWidth] = true;
+            groupUsed[(firstLane + numOfChannels - 1) / kSimdWidth] = true;
+        }
+        if (!audible)
+        {
+            for (int ch = 0; ch < numOfChannels; ++ch)
+            {
+                filterBank_->Reset(firstLane + ch);
+            }
+        }
+        voiceAudible_[oscNo] = audible;
+    }
+
+    //  whole groups, as the filter reads them : the idle lanes in them are zero already
+    SimdFloat4* rows = reinterpret_cast<SimdFloat4*>(laneBuffer_.Get());
+    const SimdFloat4    zero = SimdSplat(0.0f);
+    for (int groupNo = 0; groupNo < kNumberOfGroups; ++groupNo)
+    {
+        if (groupUsed[groupNo])
+        {
+            for (int frame = 0; frame < length; ++frame)
+            {
+                rows[frame * kNumberOfGroups + groupNo] = zero;
+            }
+        }
+    }
+
+    float*  lanes = laneBuffer_.Get();
+    for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
+    {
+        DrumOscillator* osc = oscillators_[oscNo];
+        if (osc->IsActive())
+        {
+            osc->Process(lanes + firstLanes_[oscNo], VoiceFilterBank::kMaxLanes, length);
+        }
+    }
+    filterBank_->Process(lanes, numberOfLanes_, length);
+    laneMeter_->ProcessInterleaved(lanes, VoiceFilterBank::kMaxLanes, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::MixVoices
+//  ---------------------------------------------------------------------------
+//  pan the lanes into the stems : master bus and sends.
+//  4 frames at a time, each lane group of the audible voices is transposed to one vector
+//  per lane, and every tap (lane -> stem at a gain) is one vector multiply-add.
+inline void
+Synthesizer::MixVoices(float* const* stems, int length)
+{
+    enum
+    {
+        kNumberOfGroups = VoiceFilterBank::kNumberOfGroups,
+        kNumberOfStems = EffectsBus::kNumberOfStems,
+        kMaxTaps = VoiceFilterBank::kMaxLanes * kNumberOfStems,
+    };
+    typedef struct {
+        int     lane;
+        int     stemNo;
+        float   gain;
+    } Tap;
+    Tap     taps[kMaxTaps];
+    int     numOfTaps = 0;
+    bool    stemUsed[kNumberOfStems] = { false };
+    bool    groupUsed[kNumberOfGroups] = { false };
+    for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
+    {
+        if (!voiceAudible_[oscNo])
+        {
+            continue;
+        }
+        const DrumOscillator*   osc = oscillators_[oscNo];
+        float   leftGain, rightGain;
+        osc->GetPanGain(leftGain, rightGain);
+        const int   leftLane = firstLanes_[oscNo];
+        const int   rightLane = leftLane + osc->GetNumberOfChannels() - 1;
+        for (int busNo = 0; busNo <= EffectsBus::kNumberOfSends; ++busNo)
+        {
+            //  bus 0 : master, bus 1.. : sends
+            const float level = (busNo == 0) ? 1.0f : sendLevels_[oscNo * EffectsBus::kNumberOfSends + busNo - 1];
+            if (level <= 0.0f)
+            {
+                continue;
+            }
+            const Tap   left = { leftLane, busNo * 2, leftGain * level };
+            const Tap   right = { rightLane, busNo * 2 + 1, rightGain * level };
+            taps[numOfTaps++] = left;
+            taps[numOfTaps++] = right;
+            stemUsed[busNo * 2] = true;
+            stemUsed[busNo * 2 + 1] = true;
+        }
+        groupUsed[leftLane / kSimdWidth] = true;
+        groupUsed[rightLane / kSimdWidth] = true;
+    }
+    for (int stemNo = 0; stemNo < kNumberOfStems; ++stemNo)
+    {
+        if (!stemUsed[stemNo])
+        {
+            ::memset(stems[stemNo], 0, length * sizeof(float));
+        }
+    }
+
+    const SimdFloat4*   rows = reinterpret_cast<const SimdFloat4*>(laneBuffer_.Get());
+    SimdFloat4  columns[VoiceFilterBank::kMaxLanes];     //  4 frames of each lane
+    SimdFloat4  sums[kNumberOfStems];
+    int frame = 0;
+    for (; frame + kSimdWidth <= length; frame += kSimdWidth, rows += kSimdWidth * kNumberOfGroups)
+    {
+        for (int groupNo = 0; groupNo < kNumberOfGroups; ++groupNo)
+        {
+            if (groupUsed[groupNo])
+            {
+                SimdFloat4* column = &columns[groupNo * kSimdWidth];
+                column[0] = rows[groupNo];
+                column[1] = rows[groupNo + kNumberOfGroups];
+                column[2] = rows[groupNo + kNumberOfGroups * 2];
+                column[3] = rows[groupNo + kNumberOfGroups * 3];
+                SimdTranspose4(column[0], column[1], column[2], column[3]);
+            }
+        }
+        for (int stemNo = 0; stemNo < kNumberOfStems; ++stemNo)
+        {
+            sums[stemNo] = SimdSplat(0.0f);
+        }
+        for (int tapNo = 0; tapNo < numOfTaps; ++tapNo)
+        {
+            sums[taps[tapNo].stemNo] += columns[taps[tapNo].lane] * SimdSplat(taps[tapNo].gain);
+        }
+        for (int stemNo = 0; stemNo < kNumberOfStems; ++stemNo)
+        {
+            if (stemUsed[stemNo])
+            {
+                SimdStoreUnaligned(stems[stemNo] + frame, sums[stemNo]);
+            }
+        }
+    }
+    for (; frame < length; ++frame)
+    {
+        const float*    row = laneBuffer_.Get() + frame * VoiceFilterBank::kMaxLanes;
+        for (int stemNo = 0; stemNo < kNumberOfStems; ++stemNo)
+        {
+            if (stemUsed[stemNo])
+            {
+                stems[stemNo][frame] = 0.0f;
+            }
+        }
+        for (int tapNo = 0; tapNo < numOfTaps; ++tapNo)
+        {
+            stems[taps[tapNo].stemNo][frame] += row[taps[tapNo].lane] * taps[tapNo].gain;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::WriteOutput
+//  ---------------------------------------------------------------------------
+//  write the master bus to the output
+inline void
+Synthesizer::WriteOutput(int16_t** buffer, int length)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float*    src = effectsBus_->GetMasterBuffer(ch);
+        int16_t*    dest = buffer[ch];
+        for (int frame = 0; frame < length; ++frame)
+        {
+            const int32_t   out = static_cast<int32_t>(src[frame] * 32767.0f);
+            dest[frame] = CLIP(out, -0x7FFF, 0x7FFF);
+        }
+    }
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::MeterOutput
+//  ---------------------------------------------------------------------------
+//  the master bus after the effects
+inline void
+Synthesizer::MeterOutput(int length)
+{
+    const float*    master[] = { effectsBus_->GetMasterBuffer(0), effectsBus_->GetMasterBuffer(1) };
+    masterMeter_->ProcessPlanar(master, length);
+    spectrum_->Tap(master[0], master[1], length);
+}
+
 //  ---------------------------------------------------------------------------
 //      Synthesizer::RenderAudio
 //  ---------------------------------------------------------------------------
+//  voices of a fragment between two sequencer events into the stems
 inline void
-Synthesizer::RenderAudio(AudioIO* io, int16_t** buffer, int length)
+Synthesizer::RenderAudio(float* const* stems, int offset, int length)
 {
-    for (std::vector<DrumOscillator*>::iterator ite = oscillators_.begin(); ite != oscillators_.end(); ++ite)
+    int rest = length;
+    while (rest > 0)
     {
-        (*ite)->Process(buffer, length);
-    } 
+        const int   frames = std::min<int>(rest, kRenderBlockLength);
+        this->RenderVoices(frames);
+        float*  dest[EffectsBus::kNumberOfStems];
+        for (int stemNo = 0; stemNo < EffectsBus::kNumberOfStems; ++stemNo)
+        {
+            dest[stemNo] = stems[stemNo] + offset;
+        }
+        this->MixVoices(dest, frames);
+        offset += frames;
+        rest -= frames;
+    }
 }
 
 //  ---------------------------------------------------------------------------
-//      Synthesizer::ProcessReplacing
+//      Synthesizer::ProcessBus
 //  ---------------------------------------------------------------------------
-void
-Synthesizer::ProcessReplacing(AudioIO* io, int16_t** buffer, int length)
+//  effects, meters and output of a whole block of stems in the effects bus
+inline void
+Synthesizer::ProcessBus(int16_t** buffer, int length)
 {
-    //  clear buffer
-    ::memset(buffer[0], 0, length * sizeof(int16_t));
-    ::memset(buffer[1], 0, length * sizeof(int16_t));
+    effectsBus_->Process(length);
+    this->MeterOutput(length);
+    this->WriteOutput(buffer, length);
+}
 
+//  ---------------------------------------------------------------------------
+//      Synthesizer::ProcessSequence
+//  ---------------------------------------------------------------------------
+//  run the sequencer over length frames and render between its events
+void
+Synthesizer::ProcessSequence(uint64_t hostTime, uint64_t latency, float* const* stems, int length)
+{
+    //  every frame of the stems is written by RenderAudio(), no need to clear them
+    renderHostTime_ = hostTime;
     int rest = length;
     int offset = 0;
     while (rest > 0)
     {            
         const int   frames = rest;
-        const size_t    numOfEvents = seqEvents_.size();
-        const int   processed = (seq_ != NULL) ? seq_->Process(io, offset, frames) : frames;
-        if (seqEvents_.size() > numOfEvents)
-        {
-            std::sort(seqEvents_.begin(), seqEvents_.end(), Synthesizer::SortEventFunctor);
-        }
+        //  the sequencer reports the events in frame order
+        const int   processed = (seq_ != NULL) ? seq_->Process(hostTime, latency, offset, frames) : frames;
         if (processed > 0)
         {
             int procLen = processed;
@@ -145,8 +450,7 @@ Synthesizer::ProcessReplacing(AudioIO* io, int16_t** buffer, int length)
                 }
                 if (renderLen > 0)
                 {
-                    int16_t*    output[] = { buffer[0] + curPos , buffer[1] + curPos };
-                    this->RenderAudio(io, output, renderLen);
+                    this->RenderAudio(stems, curPos, renderLen);
                 }
                 if (iteIsValid)
                 {
@@ -167,6 +471,285 @@ Synthesizer::ProcessReplacing(AudioIO* io, int16_t** buffer, int length)
     }
 }
 
+//  ---------------------------------------------------------------------------
+//      Synthesizer::ReadAhead
+//  ---------------------------------------------------------------------------
+//  look-ahead mode : the voices come from the worker, only the bus is processed here
+void
+Synthesizer::ReadAhead(AudioIO* io, int16_t** buffer, int length)
+{
+    if ((io != NULL) && (io->GetHostTime() != 0))
+    {
+        //  host time of look-ahead position 0, for the worker to time the sequencer commands
+        const uint64_t  hostTime = io->GetHostTime() - this->FramesToHostTime(lookAhead_->GetReadPosition());
+        const int64_t   prev = AtomicExchange64(&clockOrigin_, static_cast<int64_t>(hostTime));
+        AtomicStore64(&clockLatency_, static_cast<int64_t>(io->GetLatency()));
+        if (prev == 0)
+        {
+            lookAhead_->Invalidate(0);  //  rendered without a clock so far
+        }
+    }
+
+    float*  stems[EffectsBus::kNumberOfStems];
+    for (int stemNo = 0; stemNo < EffectsBus::kNumberOfStems; ++stemNo)
+    {
+        stems[stemNo] = effectsBus_->GetStem(stemNo);
+    }
+    int rest = length;
+    int offset = 0;
+    while (rest > 0)
+    {
+        const int   frames = std::min<int>(rest, kRenderBlockLength);
+        int16_t*    output[] = { buffer[0] + offset, buffer[1] + offset };
+        lookAhead_->Read(stems, frames);
+        this->ProcessBus(output, frames);
+        offset += frames;
+        rest -= frames;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::ProcessReplacing
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::ProcessReplacing(AudioIO* io, int16_t** buffer, int length)
+{
+    if (lookAhead_ != NULL)
+    {
+        this->ReadAhead(io, buffer, length);
+        return;
+    }
+    const uint64_t  hostTime = (io != NULL) ? io->GetHostTime() : 0;
+    const uint64_t  latency = (io != NULL) ? io->GetLatency() : 0;
+    float*  stems[EffectsBus::kNumberOfStems];
+    for (int stemNo = 0; stemNo < EffectsBus::kNumberOfStems; ++stemNo)
+    {
+        stems[stemNo] = effectsBus_->GetStem(stemNo);
+    }
+
+    //  the voices are rendered between the sequencer events, the bus once per block
+    int rest = length;
+    int offset = 0;
+    while (rest > 0)
+    {
+        const int   frames = std::min<int>(rest, kRenderBlockLength);
+        const uint64_t  blockHostTime = (hostTime != 0) ? hostTime + this->FramesToHostTime(offset) : 0;
+        this->ProcessSequence(blockHostTime, latency, stems, frames);
+        int16_t*    output[] = { buffer[0] + offset, buffer[1] + offset };
+        this->ProcessBus(output, frames);
+        offset += frames;
+        rest -= frames;
+    }
+}
+
+#pragma mark - look-ahead
+//
+//  voice stage state at the start of a ring block
+//
+enum
+{
+    kMaxBlockEvents = 32,
+};
+
+typedef struct {
+    int32_t frame;
+    int32_t type;
+    int32_t value;
+} BlockEvent;
+
+struct Synthesizer::Checkpoint
+{
+    Sequencer::State        sequencer;
+    VoiceFilterBank::State  filterBank;
+    DrumOscillator::State   oscillators[VoiceFilterBank::kMaxLanes];
+    BlockEvent  events[kMaxBlockEvents];    //  output events of the block
+    int         numberOfEvents;
+    uint32_t    numberOfDropped;            //  events that did not fit
+};
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetLookAheadMode
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetLookAheadMode(bool enable)
+{
+    if (enable == (lookAhead_ != NULL))
+    {
+        return;
+    }
+    if (enable)
+    {
+        checkpoints_ = new Checkpoint[kLookAheadBlocks];
+        lookAheadBase_ = seq_->GetPosition();
+        clockOrigin_ = 0;
+        clockLatency_ = 0;
+        seq_->SetCommandLogEnabled(true);
+        lookAhead_ = new LookAheadRenderer(this, EffectsBus::kNumberOfStems, kLookAheadBlockLength, kLookAheadBlocks);
+        if (!lookAhead_->Start())
+        {
+            delete lookAhead_;
+            lookAhead_ = NULL;
+        }
+    }
+    else
+    {
+        lookAhead_->Stop();
+        delete lookAhead_;
+        lookAhead_ = NULL;
+    }
+    if (lookAhead_ == NULL)
+    {
+        seq_->SetCommandLogEnabled(false);
+        delete [] checkpoints_;
+        checkpoints_ = NULL;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::GetLookAheadUnderrunCount
+//  ---------------------------------------------------------------------------
+uint32_t
+Synthesizer::GetLookAheadUnderrunCount(void) const
+{
+    return (lookAhead_ != NULL) ? lookAhead_->GetUnderrunCount() : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::FramesToHostTime
+//  ---------------------------------------------------------------------------
+uint64_t
+Synthesizer::FramesToHostTime(uint64_t frames) const
+{
+    const double    nanosec = static_cast<double>(frames) * 1000000000.0 / samlingRate_;
+    return static_cast<uint64_t>(nanosec * timebaseDenom_ / timebaseNumer_);
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::InvalidateLookAhead
+//  ---------------------------------------------------------------------------
+//  a command for hostTime (0 : now) has been queued, re-render from where it applies
+void
+Synthesizer::InvalidateLookAhead(uint64_t hostTime)
+{
+    if (lookAhead_ == NULL)
+    {
+        return;
+    }
+    uint64_t    position = 0;
+    const uint64_t  origin = static_cast<uint64_t>(AtomicLoad64(&clockOrigin_));
+    if ((hostTime != 0) && (origin != 0) && (hostTime > origin))
+    {
+        //  same mapping as Sequencer::ProcessCommands()
+        const double    nanosec = static_cast<double>(hostTime - origin) * timebaseNumer_ / timebaseDenom_
+                                    + static_cast<double>(AtomicLoad64(&clockLatency_));
+        position = static_cast<uint64_t>(nanosec * samlingRate_ / 1000000000.0);
+    }
+    lookAhead_->Invalidate(position);
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SaveCheckpoint
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SaveCheckpoint(int slotNo)
+{
+    Checkpoint& checkpoint = checkpoints_[slotNo];
+    renderSlotNo_ = slotNo;
+    checkpoint.numberOfEvents = 0;
+    checkpoint.numberOfDropped = 0;
+    seq_->SaveState(checkpoint.sequencer);
+    filterBank_->SaveState(checkpoint.filterBank);
+    for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
+    {
+        oscillators_[oscNo]->SaveState(checkpoint.oscillators[oscNo]);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::RestoreCheckpoint
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::RestoreCheckpoint(int slotNo)
+{
+    const Checkpoint&   checkpoint = checkpoints_[slotNo];
+    seq_->RestoreState(checkpoint.sequencer);
+    filterBank_->RestoreState(checkpoint.filterBank);
+    for (size_t oscNo = 0; oscNo < oscillators_.size(); ++oscNo)
+    {
+        oscillators_[oscNo]->RestoreState(checkpoint.oscillators[oscNo]);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::RenderAhead
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::RenderAhead(float* const* stems, uint64_t position, int length)
+{
+    //  commands applied in played blocks will not be rewound any more
+    seq_->DiscardCommandLog(lookAheadBase_ + lookAhead_->GetPlayedPosition());
+
+    const uint64_t  origin = static_cast<uint64_t>(AtomicLoad64(&clockOrigin_));
+    const uint64_t  hostTime = (origin != 0) ? origin + this->FramesToHostTime(position) : 0;
+    const uint64_t  latency = static_cast<uint64_t>(AtomicLoad64(&clockLatency_));
+    this->ProcessSequence(hostTime, latency, stems, length);
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::OutputViaSequencer
+//  ---------------------------------------------------------------------------
+//  frame is relative to the sequence being processed. A block rendered ahead may be
+//  rendered again, so its events are kept with the block until it is played.
+void
+Synthesizer::OutputViaSequencer(int frame, int type, int value)
+{
+    if (eventOutput_ == NULL)
+    {
+        return;
+    }
+    if (lookAhead_ != NULL)
+    {
+        Checkpoint& checkpoint = checkpoints_[renderSlotNo_];
+        if (checkpoint.numberOfEvents < kMaxBlockEvents)
+        {
+            const BlockEvent    event = { frame, type, value };
+            checkpoint.events[checkpoint.numberOfEvents++] = event;
+        }
+        else
+        {
+            ++checkpoint.numberOfDropped;   //  reported when the block is played
+        }
+        return;
+    }
+    const OutputEvent   event = { (renderHostTime_ != 0) ? renderHostTime_ + this->FramesToHostTime(frame) : 0, type, value };
+    eventOutput_->Push(event);
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::BlockClaimed
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::BlockClaimed(int slotNo, uint64_t position)
+{
+    if (eventOutput_ == NULL)
+    {
+        return;
+    }
+    const Checkpoint&   checkpoint = checkpoints_[slotNo];
+    const uint64_t  origin = static_cast<uint64_t>(AtomicLoad64(&clockOrigin_));
+    for (int index = 0; index < checkpoint.numberOfEvents; ++index)
+    {
+        const BlockEvent&   blockEvent = checkpoint.events[index];
+        const uint64_t  hostTime = (origin != 0) ? origin + this->FramesToHostTime(position + blockEvent.frame) : 0;
+        const OutputEvent   event = { hostTime, blockEvent.type, blockEvent.value };
+        eventOutput_->Push(event);
+    }
+    if (checkpoint.numberOfDropped != 0)
+    {
+        eventOutput_->CountDropped(checkpoint.numberOfDropped);
+    }
+}
+
 #pragma mark -
 //  ---------------------------------------------------------------------------
 //      Synthesizer::StartSequence
@@ -177,7 +760,9 @@ Synthesizer::StartSequence(uint64_t hostTime, float tempo)
     if (seq_ != NULL)
     {
         seq_->Start(hostTime, tempo);
+        this->InvalidateLookAhead(hostTime);
     }
+    effectsBus_->SetTempo(tempo);
 }
 
 //  ---------------------------------------------------------------------------
@@ -189,5 +774,163 @@ Synthesizer::StopSequence(uint64_t hostTime)
     if (seq_ != NULL)
     {
         seq_->Stop(hostTime);
+        this->InvalidateLookAhead(hostTime);
+    }
+}
+
+#pragma mark -
+//  ---------------------------------------------------------------------------
+//      Synthesizer::GetPatternStep
+//  ---------------------------------------------------------------------------
+bool
+Synthesizer::GetPatternStep(int trackNo, int stepNo)
+{
+    return (seq_ != NULL) ? seq_->Get(trackNo, stepNo) : false;
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetPatternStep
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetPatternStep(int trackNo, int stepNo, bool sw)
+{
+    if (seq_ != NULL)
+    {
+        seq_->Set(trackNo, stepNo, sw);
+        this->InvalidateLookAhead(0);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetPattern
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetPattern(const Sequencer::Pattern& pattern)
+{
+    if (seq_ != NULL)
+    {
+        seq_->SetPattern(pattern);
+        this->InvalidateLookAhead(0);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetPatternSwitch
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetPatternSwitch(int mode)
+{
+    if (seq_ != NULL)
+    {
+        seq_->SetPatternSwitch(mode);
+        this->InvalidateLookAhead(0);   //  a pending edit may now switch earlier or later
+    }
+}
+
+#pragma mark -
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetVoiceCutoff
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetVoiceCutoff(int voiceNo, float hz)
+{
+    if ((voiceNo >= 0) && (voiceNo < static_cast<int>(oscillators_.size())))
+    {
+        for (int ch = 0; ch < oscillators_[voiceNo]->GetNumberOfChannels(); ++ch)
+        {
+            filterBank_->SetCutoff(firstLanes_[voiceNo] + ch, hz);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetVoiceResonance
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetVoiceResonance(int voiceNo, float q)
+{
+    if ((voiceNo >= 0) && (voiceNo < static_cast<int>(oscillators_.size())))
+    {
+        for (int ch = 0; ch < oscillators_[voiceNo]->GetNumberOfChannels(); ++ch)
+        {
+            filterBank_->SetResonance(firstLanes_[voiceNo] + ch, q);
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetVoiceDecay
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetVoiceDecay(int voiceNo, float seconds)
+{
+    if ((voiceNo >= 0) && (voiceNo < static_cast<int>(oscillators_.size())))
+    {
+        for (int ch = 0; ch < oscillators_[voiceNo]->GetNumberOfChannels(); ++ch)
+        {
+            filterBank_->SetDecay(firstLanes_[voiceNo] + ch, seconds);
+        }
+    }
+}
+
+#pragma mark -
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetTrackSend
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetTrackSend(int trackNo, int sendNo, float level)
+{
+    if ((trackNo >= 0) && (trackNo < static_cast<int>(oscillators_.size())) && (sendNo >= 0) && (sendNo < EffectsBus::kNumberOfSends))
+    {
+        sendLevels_[trackNo * EffectsBus::kNumberOfSends + sendNo] = level;
+    }
+}
+
+#pragma mark - metering
+//  ---------------------------------------------------------------------------
+//      Synthesizer::GetMeters
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::GetMeters(Meters& meters) const
+{
+    LevelMeter::Levels  lanes, master;
+    laneMeter_->Read(lanes);
+    masterMeter_->Read(master);
+
+    //  a stereo voice reads as its louder lane and the mean power of both
+    meters.numberOfTracks = std::min<int>(oscillators_.size(), kMaxMeterTracks);
+    for (int trackNo = 0; trackNo < meters.numberOfTracks; ++trackNo)
+    {
+        const int   firstLane = firstLanes_[trackNo];
+        const int   numOfChannels = oscillators_[trackNo]->GetNumberOfChannels();
+        float   peak = 0.0f, meanSquare = 0.0f;
+        for (int ch = 0; ch < numOfChannels; ++ch)
+        {
+            peak = std::max(peak, lanes.peak[firstLane + ch]);
+            meanSquare += lanes.meanSquare[firstLane + ch];
+        }
+        meters.trackPeak[trackNo] = peak;
+        meters.trackRms[trackNo] = ::sqrtf(meanSquare / numOfChannels);
+    }
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        meters.masterPeak[ch] = master.peak[ch];
+        meters.masterRms[ch] = ::sqrtf(master.meanSquare[ch]);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      Synthesizer::SetSpectrumEnabled
+//  ---------------------------------------------------------------------------
+void
+Synthesizer::SetSpectrumEnabled(bool enable)
+{
+    if (enable)
+    {
+        spectrum_->Start();
+    }
+    else
+    {
+        spectrum_->Stop();
     }
 }
@@ -10,12 +10,28 @@
 
 #include <vector>
 #include "AudioIO.h"
+#include "AlignedBuffer.h"
 #include "Sequencer.h"
+#include "LookAheadRenderer.h"
 
-class Synthesizer : public AudioIOListener, SequencerListener
+class Synthesizer : public AudioIOListener, SequencerListener, LookAheadSource
 {
 public:
-    Synthesizer(float samplingRate);
+    enum
+    {
+        kMaxMeterTracks = 8,
+    };
+
+    //  linear levels, the peak falls back 20dB in 1.5 sec, the RMS is averaged over ~300 msec
+    typedef struct {
+        int     numberOfTracks;
+        float   trackPeak[kMaxMeterTracks];
+        float   trackRms[kMaxMeterTracks];
+        float   masterPeak[2];
+        float   masterRms[2];
+    } Meters;
+
+    Synthesizer(float samplingRate, bool compressSamples = false);
     ~Synthesizer(void);
 
     //  AudioIOListener
@@ -23,10 +39,41 @@ public:
 
     //  SequencerListener
     void    NoteOnViaSequencer(int frame, int partNo);
+    void    OutputViaSequencer(int frame, int type, int value);
 
     void    StartSequence(uint64_t hostTime, float tempo);
     void    StopSequence(uint64_t hostTime);
 
+    //  live pattern edit, applied at the next step (or bar) of the sequence
+    bool    GetPatternStep(int trackNo, int stepNo);
+    void    SetPatternStep(int trackNo, int stepNo, bool sw);
+    void    SetPattern(const Sequencer::Pattern& pattern);
+    void    SetPatternSwitch(int mode);
+
+    //  per voice tone shaping
+    void    SetVoiceCutoff(int voiceNo, float hz);
+    void    SetVoiceResonance(int voiceNo, float q);
+    void    SetVoiceDecay(int voiceNo, float seconds);
+
+    //  send effects
+    void    SetTrackSend(int trackNo, int sendNo, float level);
+    class EffectsBus*   GetEffectsBus(void) { return effectsBus_; }
+
+    //  render the voices ahead on a worker thread; switch while the audio I/O is stopped
+    void    SetLookAheadMode(bool enable);
+    bool    IsLookAheadMode(void) const     { return lookAhead_ != NULL; }
+    uint32_t    GetLookAheadUnderrunCount(void) const;
+
+    //  clock / start / stop / note events stamped with the host time their frame is output;
+    //  set while the audio I/O is stopped, NULL : none
+    void    SetEventOutput(EventOutput* output)     { eventOutput_ = output; }
+
+    //  metering for the UI, any thread, never blocks the audio thread. In look-ahead mode
+    //  the tracks are measured when they are rendered, up to the look-ahead time early.
+    void    GetMeters(Meters& meters) const;
+    void    SetSpectrumEnabled(bool enable);    //  runs the analyzer thread
+    class SpectrumAnalyzer* GetSpectrumAnalyzer(void)   { return spectrum_; }
+
 private:
     Synthesizer(const Synthesizer& other);                      //  not implemented
     const Synthesizer& operator= (const Synthesizer& other);    //  not implemented
@@ -36,16 +83,50 @@ private:
         int     paramType;
         int     value0;
     } SequencerEvent;
-    static inline bool   SortEventFunctor(const Synthesizer::SequencerEvent& left, const Synthesizer::SequencerEvent& right)
-    {
-        return (left.frame == right.frame) ? (left.paramType < right.paramType) : (left.frame < right.frame);
-    }
 
-    void    RenderAudio(AudioIO* io, int16_t** buffer, int length);
+    void    ProcessSequence(uint64_t hostTime, uint64_t latency, float* const* stems, int length);
+    void    RenderAudio(float* const* stems, int offset, int length);
+    void    RenderVoices(int length);
+    void    MixVoices(float* const* stems, int length);
+    void    WriteOutput(int16_t** buffer, int length);
+    void    MeterOutput(int length);
+    void    ProcessBus(int16_t** buffer, int length);
     void    DecodeSeqEvent(const SequencerEvent* event);
 
+    //  look-ahead
+    struct Checkpoint;
+    void    ReadAhead(AudioIO* io, int16_t** buffer, int length);
+    void    InvalidateLookAhead(uint64_t hostTime);
+    uint64_t    FramesToHostTime(uint64_t frames) const;
+
+    //  LookAheadSource
+    void    SaveCheckpoint(int slotNo);
+    void    RestoreCheckpoint(int slotNo);
+    void    RenderAhead(float* const* stems, uint64_t position, int length);
+    void    BlockClaimed(int slotNo, uint64_t position);
+
     const float samlingRate_;
     Sequencer*  seq_;
     std::vector<SequencerEvent> seqEvents_;
     std::vector<class DrumOscillator*> oscillators_;
+    std::vector<int>    firstLanes_;    //  filter bank lane of each oscillator
+    std::vector<bool>   voiceAudible_;  //  oscillator playing or its filter ringing
+    int     numberOfLanes_;
+    class VoiceFilterBank*  filterBank_;
+    AlignedBuffer<float>    laneBuffer_;    //  SimdFloat4 access by the filter bank
+    class EffectsBus*   effectsBus_;
+    std::vector<float>  sendLevels_;    //  [trackNo * kNumberOfSends + sendNo]
+    LookAheadRenderer*  lookAhead_;
+    Checkpoint*         checkpoints_;       //  one per ring block
+    uint64_t            lookAheadBase_;     //  sequencer position of look-ahead position 0
+    volatile int64_t    clockOrigin_;       //  host time of look-ahead position 0, 0 : unknown
+    volatile int64_t    clockLatency_;
+    uint32_t    timebaseNumer_;
+    uint32_t    timebaseDenom_;
+    EventOutput*    eventOutput_;
+    class LevelMeter*   laneMeter_;     //  written by the thread rendering the voices
+    class LevelMeter*   masterMeter_;   //  written by the audio thread
+    class SpectrumAnalyzer* spectrum_;
+    uint64_t    renderHostTime_;        //  host time of frame 0 of the sequence being processed
+    int         renderSlotNo_;          //  ring block being rendered ahead
 };
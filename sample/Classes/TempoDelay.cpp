@@ -0,0 +1,133 @@
+//
+//  TempoDelay.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include <algorithm>
+#include "TempoDelay.h"
+#include "SimdTypes.h"
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::TempoDelay
+//  ---------------------------------------------------------------------------
+TempoDelay::TempoDelay(float samplingRate, float maxSeconds, int maxBlockLength) :
+samplingRate_(samplingRate),
+minDelayFrames_(maxBlockLength),
+lineLength_(static_cast<int>(samplingRate * maxSeconds) + maxBlockLength),
+lineLeft_(lineLength_),
+lineRight_(lineLength_),
+writePos_(0),
+delayFrames_(static_cast<int32_t>(samplingRate * 0.375f)),
+feedback_(0.4f)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::~TempoDelay
+//  ---------------------------------------------------------------------------
+TempoDelay::~TempoDelay(void)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::SetDelayTime
+//  ---------------------------------------------------------------------------
+void
+TempoDelay::SetDelayTime(float seconds)
+{
+    const int   frames = static_cast<int>(seconds * samplingRate_);
+    delayFrames_ = std::min(std::max(frames, minDelayFrames_), lineLength_ - minDelayFrames_);
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::SetFeedback
+//  ---------------------------------------------------------------------------
+void
+TempoDelay::SetFeedback(float feedback)
+{
+    feedback_ = std::min(std::max(feedback, 0.0f), 0.95f);
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::GetTailSeconds
+//  ---------------------------------------------------------------------------
+//  time for the repeats to fall below -90dB
+float
+TempoDelay::GetTailSeconds(void) const
+{
+    const float feedback = std::max(static_cast<float>(feedback_), 0.001f);
+    const float repeats = ::logf(0.0000316f) / ::logf(feedback);
+    return (repeats + 1.0f) * delayFrames_ / samplingRate_;
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::Clear
+//  ---------------------------------------------------------------------------
+void
+TempoDelay::Clear(void)
+{
+    lineLeft_.Clear();
+    lineRight_.Clear();
+}
+
+//  ---------------------------------------------------------------------------
+//      TempoDelay::Process
+//  ---------------------------------------------------------------------------
+void
+TempoDelay::Process(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float returnLevel, int length)
+{
+    const int   delayFrames = delayFrames_;
+    const float feedback = feedback_;
+    const SimdFloat4    feedbackVec = SimdSplat(feedback);
+    const SimdFloat4    returnVec = SimdSplat(returnLevel);
+    int done = 0;
+    while (done < length)
+    {
+        int readPos = writePos_ - delayFrames;
+        if (readPos < 0)
+        {
+            readPos += lineLength_;
+        }
+        //  contiguous part of the write and read ranges
+        const int   frames = std::min(length - done, std::min(lineLength_ - writePos_, lineLength_ - readPos));
+        float*  writeLeft = &lineLeft_[writePos_];
+        float*  writeRight = &lineRight_[writePos_];
+        const float*    readLeft = &lineLeft_[readPos];
+        const float*    readRight = &lineRight_[readPos];
+        const float*    srcLeft = inLeft + done;
+        const float*    srcRight = inRight + done;
+        float*  destLeft = outLeft + done;
+        float*  destRight = outRight + done;
+
+        int frame = 0;
+        for (; frame + kSimdWidth <= frames; frame += kSimdWidth)
+        {
+            const SimdFloat4    delayedLeft = SimdLoadUnaligned(readLeft + frame);
+            const SimdFloat4    delayedRight = SimdLoadUnaligned(readRight + frame);
+            SimdStoreUnaligned(writeLeft + frame, SimdLoadUnaligned(srcLeft + frame) + delayedRight * feedbackVec);
+            SimdStoreUnaligned(writeRight + frame, SimdLoadUnaligned(srcRight + frame) + delayedLeft * feedbackVec);
+            SimdStoreUnaligned(destLeft + frame, SimdLoadUnaligned(destLeft + frame) + delayedLeft * returnVec);
+            SimdStoreUnaligned(destRight + frame, SimdLoadUnaligned(destRight + frame) + delayedRight * returnVec);
+        }
+        for (; frame < frames; ++frame)
+        {
+            const float delayedLeft = readLeft[frame];
+            const float delayedRight = readRight[frame];
+            writeLeft[frame] = srcLeft[frame] + delayedRight * feedback;
+            writeRight[frame] = srcRight[frame] + delayedLeft * feedback;
+            destLeft[frame] += delayedLeft * returnLevel;
+            destRight[frame] += delayedRight * returnLevel;
+        }
+
+        writePos_ += frames;
+        if (writePos_ >= lineLength_)
+        {
+            writePos_ -= lineLength_;
+        }
+        done += frames;
+    }
+}
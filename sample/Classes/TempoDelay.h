@@ -0,0 +1,44 @@
+//
+//  TempoDelay.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "AlignedBuffer.h"
+
+//
+//  stereo ping-pong delay, processed a block at a time.
+//  The delay is never shorter than the block, so a block reads and writes disjoint ranges.
+//
+class TempoDelay
+{
+public:
+    TempoDelay(float samplingRate, float maxSeconds, int maxBlockLength);
+    ~TempoDelay(void);
+
+    void    SetDelayTime(float seconds);
+    void    SetFeedback(float feedback);
+    float   GetTailSeconds(void) const;
+    void    Clear(void);
+
+    //  out += delayed(in) * returnLevel
+    void    Process(const float* inLeft, const float* inRight, float* outLeft, float* outRight, float returnLevel, int length);
+
+private:
+    TempoDelay(const TempoDelay& other);                        //  not implemented
+    const TempoDelay& operator= (const TempoDelay& other);      //  not implemented
+
+    const float samplingRate_;
+    const int   minDelayFrames_;
+    const int   lineLength_;
+    AlignedBuffer<float>    lineLeft_;
+    AlignedBuffer<float>    lineRight_;
+    int     writePos_;
+    volatile int32_t    delayFrames_;
+    volatile float  feedback_;
+};
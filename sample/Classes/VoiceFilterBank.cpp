@@ -0,0 +1,223 @@
+//
+//  VoiceFilterBank.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#include <math.h>
+#include "VoiceFilterBank.h"
+#include "AtomicOps.h"
+
+static const float  kSilenceLevel = 0.00001f;   //  -100dB
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::VoiceFilterBank
+//  ---------------------------------------------------------------------------
+VoiceFilterBank::VoiceFilterBank(float samplingRate) :
+samplingRate_(samplingRate),
+paramsChanged_(1)
+{
+    for (int groupNo = 0; groupNo < kNumberOfGroups; ++groupNo)
+    {
+        ic1eq_[groupNo] = SimdSplat(0.0f);
+        ic2eq_[groupNo] = SimdSplat(0.0f);
+        env_[groupNo] = SimdSplat(1.0f);
+    }
+    for (int lane = 0; lane < kMaxLanes; ++lane)
+    {
+        cutoff_[lane] = 20000.0f;   //  open
+        resonance_[lane] = 0.7071f;
+        decay_[lane] = 0.0f;        //  no decay
+    }
+    this->UpdateCoefficients();
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::~VoiceFilterBank
+//  ---------------------------------------------------------------------------
+VoiceFilterBank::~VoiceFilterBank(void)
+{
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::SetCutoff
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::SetCutoff(int lane, float hz)
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        cutoff_[lane] = hz;
+        AtomicStore32(&paramsChanged_, 1);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::SetResonance
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::SetResonance(int lane, float q)
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        resonance_[lane] = q;
+        AtomicStore32(&paramsChanged_, 1);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::SetDecay
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::SetDecay(int lane, float seconds)
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        decay_[lane] = seconds;
+        AtomicStore32(&paramsChanged_, 1);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::UpdateCoefficients
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::UpdateCoefficients(void)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    //  trapezoidal SVF (Simper)
+    for (int lane = 0; lane < kMaxLanes; ++lane)
+    {
+        const int   groupNo = lane / kSimdWidth;
+        const int   index = lane % kSimdWidth;
+        const float cutoff = CLIP(cutoff_[lane], 20.0f, samplingRate_ * 0.49f);
+        const float q = CLIP(resonance_[lane], 0.5f, 20.0f);
+        const float g = ::tanf(static_cast<float>(M_PI) * cutoff / samplingRate_);
+        const float k = 1.0f / q;
+        const float a1 = 1.0f / (1.0f + g * (g + k));
+        a1_[groupNo][index] = a1;
+        a2_[groupNo][index] = g * a1;
+        a3_[groupNo][index] = g * g * a1;
+
+        const float decay = decay_[lane];
+        decayCoef_[groupNo][index] = (decay > 0.0f) ? ::expf(::logf(0.001f) / (decay * samplingRate_)) : 1.0f;
+    }
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::Trigger
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::Trigger(int lane)
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        const int   groupNo = lane / kSimdWidth;
+        const int   index = lane % kSimdWidth;
+        env_[groupNo][index] = 1.0f;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::IsRinging
+//  ---------------------------------------------------------------------------
+//  true while the filter state of the lane is above the silence level
+bool
+VoiceFilterBank::IsRinging(int lane) const
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        const int   groupNo = lane / kSimdWidth;
+        const int   index = lane % kSimdWidth;
+        return (::fabsf(ic1eq_[groupNo][index]) > kSilenceLevel) || (::fabsf(ic2eq_[groupNo][index]) > kSilenceLevel);
+    }
+    return false;
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::Reset
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::Reset(int lane)
+{
+    if ((lane >= 0) && (lane < kMaxLanes))
+    {
+        const int   groupNo = lane / kSimdWidth;
+        const int   index = lane % kSimdWidth;
+        ic1eq_[groupNo][index] = 0.0f;
+        ic2eq_[groupNo][index] = 0.0f;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::Process
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::Process(float* buffer, int numberOfLanes, int length)
+{
+    if (AtomicCompareAndSwap32(1, 0, &paramsChanged_))
+    {
+        this->UpdateCoefficients();
+    }
+
+    //  x + bias - bias is exact for signal levels and flushes anything below ~1e-25 to zero,
+    //  so the state of a silent voice never decays into the denormal range
+    const int   numOfGroups = (numberOfLanes + kSimdWidth - 1) / kSimdWidth;
+    const SimdFloat4    two = SimdSplat(2.0f);
+    const SimdFloat4    antiDenormal = SimdSplat(1.0e-18f);
+    for (int groupNo = 0; groupNo < numOfGroups; ++groupNo)
+    {
+        SimdFloat4  ic1eq = ic1eq_[groupNo];
+        SimdFloat4  ic2eq = ic2eq_[groupNo];
+        SimdFloat4  env = env_[groupNo];
+        const SimdFloat4    a1 = a1_[groupNo];
+        const SimdFloat4    a2 = a2_[groupNo];
+        const SimdFloat4    a3 = a3_[groupNo];
+        const SimdFloat4    decayCoef = decayCoef_[groupNo];
+        SimdFloat4* io = reinterpret_cast<SimdFloat4*>(buffer) + groupNo;
+        for (int frame = 0; frame < length; ++frame, io += kNumberOfGroups)
+        {
+            const SimdFloat4    v3 = *io - ic2eq;
+            const SimdFloat4    v1 = a1 * ic1eq + a2 * v3;
+            const SimdFloat4    v2 = ic2eq + a2 * ic1eq + a3 * v3;
+            ic1eq = ((two * v1 - ic1eq) + antiDenormal) - antiDenormal;
+            ic2eq = ((two * v2 - ic2eq) + antiDenormal) - antiDenormal;
+            *io = v2 * env;
+            env = env * decayCoef;
+        }
+        ic1eq_[groupNo] = ic1eq;
+        ic2eq_[groupNo] = ic2eq;
+        env_[groupNo] = (env + antiDenormal) - antiDenormal;  //  decays slowly, once per block is enough
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::SaveState
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::SaveState(State& state) const
+{
+    for (int groupNo = 0; groupNo < kNumberOfGroups; ++groupNo)
+    {
+        state.ic1eq[groupNo] = ic1eq_[groupNo];
+        state.ic2eq[groupNo] = ic2eq_[groupNo];
+        state.env[groupNo] = env_[groupNo];
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      VoiceFilterBank::RestoreState
+//  ---------------------------------------------------------------------------
+void
+VoiceFilterBank::RestoreState(const State& state)
+{
+    for (int groupNo = 0; groupNo < kNumberOfGroups; ++groupNo)
+    {
+        ic1eq_[groupNo] = state.ic1eq[groupNo];
+        ic2eq_[groupNo] = state.ic2eq[groupNo];
+        env_[groupNo] = state.env[groupNo];
+    }
+}
@@ -0,0 +1,74 @@
+//
+//  VoiceFilterBank.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "SimdTypes.h"
+
+//
+//  Per-voice state-variable lowpass filter and decay envelope.
+//  The state is kept structure-of-arrays: one lane per voice channel, so kSimdWidth
+//  lanes (voices) are filtered with one vector operation per frame.
+//  Input / output is lane-interleaved : buffer[frame * kMaxLanes + lane].
+//
+class VoiceFilterBank
+{
+public:
+    enum
+    {
+        kMaxLanes = 16,
+        kNumberOfGroups = kMaxLanes / kSimdWidth,
+    };
+
+    typedef struct {
+        SimdFloat4  ic1eq[kNumberOfGroups];
+        SimdFloat4  ic2eq[kNumberOfGroups];
+        SimdFloat4  env[kNumberOfGroups];
+    } State;
+
+    VoiceFilterBank(float samplingRate);
+    ~VoiceFilterBank(void);
+
+    //  any thread; applied at the next Process()
+    void    SetCutoff(int lane, float hz);
+    void    SetResonance(int lane, float q);
+    void    SetDecay(int lane, float seconds);   //  time to -60dB, <= 0 : no decay
+
+    //  audio thread
+    void    Trigger(int lane);      //  restarts the envelope, the filter keeps ringing
+    bool    IsRinging(int lane) const;
+    void    Reset(int lane);        //  zero state : silent input gives exact silence
+    void    Process(float* buffer, int numberOfLanes, int length);
+    void    SaveState(State& state) const;
+    void    RestoreState(const State& state);
+
+private:
+    VoiceFilterBank(const VoiceFilterBank& other);                      //  not implemented
+    const VoiceFilterBank& operator= (const VoiceFilterBank& other);    //  not implemented
+
+    void    UpdateCoefficients(void);
+
+    const float samplingRate_;
+
+    //  filter / envelope state
+    SimdFloat4  ic1eq_[kNumberOfGroups];
+    SimdFloat4  ic2eq_[kNumberOfGroups];
+    SimdFloat4  env_[kNumberOfGroups];
+    //  coefficients
+    SimdFloat4  a1_[kNumberOfGroups];
+    SimdFloat4  a2_[kNumberOfGroups];
+    SimdFloat4  a3_[kNumberOfGroups];
+    SimdFloat4  decayCoef_[kNumberOfGroups];
+
+    //  parameters, written by the control thread
+    volatile float  cutoff_[kMaxLanes];
+    volatile float  resonance_[kMaxLanes];
+    volatile float  decay_[kMaxLanes];
+    volatile int32_t    paramsChanged_;
+};
@@ -20,12 +20,22 @@
     IBOutlet UISlider*  tempoSlider;
     IBOutlet UITextField*   tempoText;
     IBOutlet UILabel*   statusLabel;
+    IBOutlet UISwitch*  lowLatencySwitch;
 
     float   tempo_;
 
     KorgWirelessSyncStart*  wist_;
     class Synthesizer*      synth_;
+    class AudioGraph*       graph_;
     class AudioIO*          audioIo_;
+    class EventOutput*      eventOutput_;
+    class FileEventSink*    eventSink_;
+
+    NSTimer*        meterTimer_;        //  polls the meters while the view is shown
+    UIView*         meterView_;
+    NSMutableArray* levelBars_;         //  RMS of the tracks, then of the master L / R
+    NSMutableArray* peakMarks_;
+    NSMutableArray* spectrumBars_;
 }
 
 @property (nonatomic, retain) UISwitch* wistSwitch;
@@ -35,12 +45,14 @@
 @property (nonatomic, retain) UISlider* tempoSlider;
 @property (nonatomic, retain) UITextField* tempoText;
 @property (nonatomic, retain) UILabel* statusLabel;
+@property (nonatomic, retain) UISwitch* lowLatencySwitch;
 
 - (IBAction)wistSwitchPushed:(id)sender;
 - (IBAction)startButtonPushed:(id)sender;
 - (IBAction)stopButtonPushed:(id)sender;
 - (IBAction)aboutButtonPushed:(id)sender;
 - (IBAction)tempoSliderChanged:(id)sender;
+- (IBAction)lowLatencySwitchPushed:(id)sender;
 
 - (void)disconnectWist;
 
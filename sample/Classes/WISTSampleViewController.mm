@@ -7,14 +7,38 @@
 //
 
 #import <mach/mach_time.h>
+#import <algorithm>
 #import "WISTSampleViewController.h"
 #import "KorgWirelessSyncStart.h"
 #import "AudioIO.h"
 #import "Synthesizer.h"
+#import "AudioGraph.h"
+#import "EventOutput.h"
+#import "SpectrumAnalyzer.h"
 #import "AboutWISTViewController.h"
 
+//  user default (or launch argument "-EventLogEnabled YES") : log the clock / start / stop / note
+//  output events to Documents/events.txt, shared through iTunes
+static NSString*    kEventLogEnabledKey = @"EventLogEnabled";
+
+enum
+{
+    kNumberOfLevelMeters = Synthesizer::kMaxMeterTracks + 2,
+    kSpectrumBands = 32,            //  log spaced from kSpectrumLowestHz to Nyquist
+};
+static const NSTimeInterval kMeterInterval = 1.0 / 30;
+static const float  kMeterFloorDB = -60.0f;
+static const float  kSpectrumFloorDB = -90.0f;
+static const float  kSpectrumLowestHz = 40.0f;
+static const CGFloat    kMeterHeight = 30.0f;
+static const CGFloat    kLevelBarWidth = 6.0f;
+static const CGFloat    kLevelBarPitch = 8.0f;
+
 @interface WISTSampleViewController()
 @property (nonatomic, assign) float tempo;
+- (void)startEventLog;
+- (void)createMeterView;
+- (void)updateMeters:(NSTimer*)timer;
 - (void)updateTempoUI:(BOOL)animated;
 - (void)updateWistUI:(BOOL)animated;
 @end
@@ -28,6 +52,7 @@
 @synthesize tempoSlider;
 @synthesize tempoText;
 @synthesize statusLabel;
+@synthesize lowLatencySwitch;
 @synthesize tempo = tempo_;
 
 //  ---------------------------------------------------------------------------
@@ -51,14 +76,47 @@
 
         const float fs = 44100.0f;
         synth_ = new Synthesizer(fs);
+        graph_ = new AudioGraph(4096);
+        const int   synthNode = graph_->AddNode(synth_);
+        graph_->SetOutput(synthNode, true);
+        graph_->Commit();
+        if ([[NSUserDefaults standardUserDefaults] boolForKey:kEventLogEnabledKey])
+        {
+            [self startEventLog];   //  before the audio starts
+        }
         audioIo_ = new AudioIO(fs);
-        audioIo_->SetListener(synth_);
+        audioIo_->SetListener(graph_);
         audioIo_->Open();
         audioIo_->Start();
     }
     return self;
 }
 
+//  ---------------------------------------------------------------------------
+//      startEventLog
+//  ---------------------------------------------------------------------------
+- (void)startEventLog
+{
+    NSString*   folder = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    NSString*   path = [folder stringByAppendingPathComponent:@"events.txt"];
+    eventSink_ = new FileEventSink([path fileSystemRepresentation]);
+    if (eventSink_->IsOpen())
+    {
+        eventOutput_ = new EventOutput();
+        eventOutput_->SetSink(eventSink_);
+        if (eventOutput_->Start())
+        {
+            synth_->SetEventOutput(eventOutput_);
+            return;
+        }
+        delete eventOutput_;
+        eventOutput_ = NULL;
+    }
+    DEBUG_LOG(@"event log not started : %@", path);
+    delete eventSink_;
+    eventSink_ = NULL;
+}
+
 - (void) dismissBrowser
 {
     [self dismissViewControllerAnimated:YES completion:nil];
@@ -76,6 +134,16 @@
     self.tempoSlider = nil;
     self.tempoText = nil;
     self.statusLabel = nil;
+    self.lowLatencySwitch = nil;
+
+    [meterView_ release];
+    meterView_ = nil;
+    [levelBars_ release];
+    levelBars_ = nil;
+    [peakMarks_ release];
+    peakMarks_ = nil;
+    [spectrumBars_ release];
+    spectrumBars_ = nil;
 }
 
 //  ---------------------------------------------------------------------------
@@ -87,9 +155,16 @@
     
     delete audioIo_;
     audioIo_ = NULL;
+    delete eventOutput_;    //  sends what is left to the sink
+    eventOutput_ = NULL;
+    delete eventSink_;
+    eventSink_ = NULL;
+    delete graph_;
+    graph_ = NULL;
     delete synth_;
     synth_ = NULL;
 
+    [wist_ invalidate];
     [wist_ release];
     wist_ = nil;
 
@@ -104,6 +179,7 @@
 - (void)viewDidLoad
 {
     [super viewDidLoad];
+    [self createMeterView];
 }
 
 //  ---------------------------------------------------------------------------
@@ -115,6 +191,28 @@
 
     [self updateTempoUI:NO];
     [self updateWistUI:NO];
+    [self.lowLatencySwitch setOn:((audioIo_ != NULL) && audioIo_->IsLowLatencyMode()) animated:NO];
+
+    //  the analyzer thread only runs while there is a spectrum to show
+    synth_->SetSpectrumEnabled(true);
+    if (meterTimer_ == nil)
+    {
+        meterTimer_ = [[NSTimer scheduledTimerWithTimeInterval:kMeterInterval target:self selector:@selector(updateMeters:)
+                                                      userInfo:nil repeats:YES] retain];
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      viewWillDisappear
+//  ---------------------------------------------------------------------------
+- (void)viewWillDisappear:(BOOL)animated
+{
+    [meterTimer_ invalidate];   //  the timer retains self, dealloc can not come before this
+    [meterTimer_ release];
+    meterTimer_ = nil;
+    synth_->SetSpectrumEnabled(false);
+
+    [super viewWillDisappear:animated];
 }
 
 //  ---------------------------------------------------------------------------
@@ -161,6 +259,116 @@
     self.statusLabel.text = wist_.isConnected ? (wist_.isMaster ? @"Master mode" : @"Slave mode") : @"";
 }
 
+#pragma mark - meters
+//  ---------------------------------------------------------------------------
+//      createMeterView
+//  ---------------------------------------------------------------------------
+//  a strip along the bottom : a level bar and a peak mark per track and master channel,
+//  then the spectrum bands; laid out by updateMeters
+- (void)createMeterView
+{
+    const CGRect    bounds = self.view.bounds;
+    meterView_ = [[UIView alloc] initWithFrame:CGRectMake(20.0f, bounds.size.height - kMeterHeight - 4.0f, bounds.size.width - 40.0f, kMeterHeight)];
+    meterView_.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleTopMargin;
+    meterView_.userInteractionEnabled = NO;
+    [self.view addSubview:meterView_];
+
+    levelBars_ = [[NSMutableArray alloc] initWithCapacity:kNumberOfLevelMeters];
+    peakMarks_ = [[NSMutableArray alloc] initWithCapacity:kNumberOfLevelMeters];
+    for (int meterNo = 0; meterNo < kNumberOfLevelMeters; ++meterNo)
+    {
+        UIView* bar = [[[UIView alloc] initWithFrame:CGRectZero] autorelease];
+        bar.backgroundColor = (meterNo < Synthesizer::kMaxMeterTracks) ? [UIColor greenColor] : [UIColor orangeColor];
+        [meterView_ addSubview:bar];
+        [levelBars_ addObject:bar];
+        UIView* mark = [[[UIView alloc] initWithFrame:CGRectZero] autorelease];
+        mark.backgroundColor = [UIColor redColor];
+        [meterView_ addSubview:mark];
+        [peakMarks_ addObject:mark];
+    }
+    spectrumBars_ = [[NSMutableArray alloc] initWithCapacity:kSpectrumBands];
+    for (int bandNo = 0; bandNo < kSpectrumBands; ++bandNo)
+    {
+        UIView* bar = [[[UIView alloc] initWithFrame:CGRectZero] autorelease];
+        bar.backgroundColor = [UIColor cyanColor];
+        [meterView_ addSubview:bar];
+        [spectrumBars_ addObject:bar];
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      meterFraction
+//  ---------------------------------------------------------------------------
+//  dB -> 0 (floorDB) .. 1 (0dB)
+static inline CGFloat
+meterFraction(float dB, float floorDB)
+{
+    return std::min(std::max((dB - floorDB) / -floorDB, 0.0f), 1.0f);
+}
+
+//  ---------------------------------------------------------------------------
+//      linearToDB
+//  ---------------------------------------------------------------------------
+static inline float
+linearToDB(float level)
+{
+    return 20.0f * ::log10f(std::max(level, 1.0e-6f));
+}
+
+//  ---------------------------------------------------------------------------
+//      updateMeters
+//  ---------------------------------------------------------------------------
+- (void)updateMeters:(NSTimer*)timer
+{
+    if ((synth_ == NULL) || (meterView_ == nil))
+    {
+        return;
+    }
+    const CGSize    size = meterView_.bounds.size;
+
+    Synthesizer::Meters meters;
+    synth_->GetMeters(meters);
+    for (int meterNo = 0; meterNo < kNumberOfLevelMeters; ++meterNo)
+    {
+        const int   ch = meterNo - Synthesizer::kMaxMeterTracks;
+        const bool  isMaster = (ch >= 0);
+        const float rms = isMaster ? meters.masterRms[ch] : meters.trackRms[meterNo];
+        const float peak = isMaster ? meters.masterPeak[ch] : meters.trackPeak[meterNo];
+        const CGFloat   x = meterNo * kLevelBarPitch + (isMaster ? kLevelBarPitch / 2 : 0.0f);
+        const CGFloat   rmsHeight = size.height * meterFraction(linearToDB(rms), kMeterFloorDB);
+        const CGFloat   peakHeight = size.height * meterFraction(linearToDB(peak), kMeterFloorDB);
+        UIView* bar = [levelBars_ objectAtIndex:meterNo];
+        UIView* mark = [peakMarks_ objectAtIndex:meterNo];
+        bar.frame = CGRectMake(x, size.height - rmsHeight, kLevelBarWidth, rmsHeight);
+        mark.frame = CGRectMake(x, size.height - std::max(peakHeight, static_cast<CGFloat>(2.0f)), kLevelBarWidth, 2.0f);
+        bar.hidden = mark.hidden = (!isMaster && (meterNo >= meters.numberOfTracks));
+    }
+
+    //  the loudest bin of each band
+    const SpectrumAnalyzer* analyzer = synth_->GetSpectrumAnalyzer();
+    SpectrumAnalyzer::Spectrum  spectrum;
+    analyzer->Read(spectrum);
+    const float binWidth = analyzer->GetBinWidth();
+    const float nyquist = binWidth * SpectrumAnalyzer::kNumberOfBins;
+    const CGFloat   left = kNumberOfLevelMeters * kLevelBarPitch + 2 * kLevelBarPitch;
+    const CGFloat   bandPitch = (size.width - left) / kSpectrumBands;
+    int fromBin = std::max(1, static_cast<int>(kSpectrumLowestHz / binWidth));
+    for (int bandNo = 0; bandNo < kSpectrumBands; ++bandNo)
+    {
+        const float toHz = kSpectrumLowestHz * ::powf(nyquist / kSpectrumLowestHz, (bandNo + 1.0f) / kSpectrumBands);
+        const int   toBin = std::min(std::max(fromBin + 1, static_cast<int>(toHz / binWidth)), static_cast<int>(SpectrumAnalyzer::kNumberOfBins));
+        float   dB = kSpectrumFloorDB;
+        for (int binNo = fromBin; binNo < toBin; ++binNo)
+        {
+            dB = std::max(dB, spectrum.magnitude[binNo]);
+        }
+        fromBin = toBin;
+        const CGFloat   height = size.height * meterFraction(dB, kSpectrumFloorDB);
+        UIView* bar = [spectrumBars_ objectAtIndex:bandNo];
+        bar.frame = CGRectMake(left + bandNo * bandPitch, size.height - height, bandPitch - 1.0f, height);
+    }
+}
+
 #pragma mark -
 //  ---------------------------------------------------------------------------
 //      setTempo
@@ -327,6 +535,21 @@
     [self updateTempoUI:NO];
 }
 
+//  ---------------------------------------------------------------------------
+//      lowLatencySwitchPushed
+//  ---------------------------------------------------------------------------
+- (IBAction)lowLatencySwitchPushed:(id)sender
+{
+    if (audioIo_ != NULL)
+    {
+        audioIo_->SetLowLatencyMode(((UISwitch*)sender).on);
+        if (wist_.isConnected)
+        {
+            wist_.latency = [self latency];     //  the output latency has changed
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark @protocol KorgWirelessSyncStartDelegate
 //  ---------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+//
+//  AudioGraphTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Runs the same graph with the parallel schedule (helper thread claiming steps) and
+//  with the serial one, and requires bit identical output, also across a re-commit.
+//
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <vector>
+#include "AudioGraph.h"
+#include "AtomicOps.h"
+#include "TestCheck.h"
+
+static pthread_t            gAudioThread;
+static volatile int32_t     gHelperSteps = 0;
+
+//  ---------------------------------------------------------------------------
+//      CountHelperStep
+//  ---------------------------------------------------------------------------
+static void
+CountHelperStep(void)
+{
+    if (!::pthread_equal(::pthread_self(), gAudioThread))
+    {
+        while (true)
+        {
+            const int32_t   count = gHelperSteps;
+            if (AtomicCompareAndSwap32(count, count + 1, &gHelperSteps))
+            {
+                break;
+            }
+        }
+    }
+}
+
+//
+//  deterministic noise, the state advances once per callback whichever thread runs it
+//
+class ToneNode : public AudioIOListener
+{
+public:
+    ToneNode(uint32_t seed) : state_(seed)  {}
+
+    void    ProcessReplacing(AudioIO* /*io*/, int16_t** buffer, int length)
+    {
+        for (int i = 0; i < length; ++i)
+        {
+            state_ = state_ * 1664525u + 1013904223u;
+            buffer[0][i] = static_cast<int16_t>(state_ >> 20);
+            buffer[1][i] = static_cast<int16_t>(state_ >> 17);
+        }
+        CountHelperStep();
+    }
+
+private:
+    uint32_t    state_;
+};
+
+//
+//  gain and offset, sleeps now and then so that either thread may be late
+//
+class FilterNode : public AudioIOListener
+{
+public:
+    FilterNode(int offset) : offset_(offset), calls_(0)     {}
+
+    void    ProcessReplacing(AudioIO* /*io*/, int16_t** buffer, int length)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                buffer[ch][i] = static_cast<int16_t>(buffer[ch][i] * 3 / 4 + offset_);
+            }
+        }
+        if ((++calls_ % 7) == static_cast<uint32_t>(offset_ % 7))
+        {
+            ::usleep(20);
+        }
+        CountHelperStep();
+    }
+
+private:
+    const int   offset_;
+    uint32_t    calls_;
+};
+
+//
+//  6 sources, 4 + 2 filters in two levels, 3 outputs
+//
+class TestGraph
+{
+public:
+    TestGraph(bool parallel) : graph_(256, parallel), tones_(), filters_(), nodes_()
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            tones_.push_back(new ToneNode(i + 1));
+            nodes_.push_back(graph_.AddNode(tones_.back()));
+        }
+        for (int i = 0; i < 6; ++i)
+        {
+            filters_.push_back(new FilterNode(i * 11));
+            nodes_.push_back(graph_.AddNode(filters_.back()));
+        }
+        this->Connect(0, 6);
+        this->Connect(1, 6);
+        this->Connect(2, 7);
+        this->Connect(3, 7);
+        this->Connect(4, 8);
+        this->Connect(5, 9);
+        this->Connect(0, 9);
+        this->Connect(6, 10);
+        this->Connect(7, 10);
+        this->Connect(8, 11);
+        this->Connect(9, 11);
+        graph_.SetOutput(nodes_[10], true);
+        graph_.SetOutput(nodes_[11], true);
+        graph_.SetOutput(nodes_[1], true);
+        TEST_CHECK(graph_.Commit());
+    }
+
+    ~TestGraph(void)
+    {
+        for (size_t i = 0; i < tones_.size(); ++i)
+        {
+            delete tones_[i];
+        }
+        for (size_t i = 0; i < filters_.size(); ++i)
+        {
+            delete filters_[i];
+        }
+    }
+
+    void    Connect(int src, int dest)      { TEST_CHECK(graph_.Connect(nodes_[src], nodes_[dest])); }
+    void    Disconnect(int src, int dest)   { graph_.Disconnect(nodes_[src], nodes_[dest]); }
+    AudioGraph& Graph(void)     { return graph_; }
+
+private:
+    AudioGraph  graph_;
+    std::vector<ToneNode*>      tones_;
+    std::vector<FilterNode*>    filters_;
+    std::vector<int>            nodes_;
+};
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    gAudioThread = ::pthread_self();
+
+    TestGraph   serial(false);
+    TestGraph   parallel(true);
+
+    const int   kMaxLength = 600;   //  longer than the graph's 256 frames : split into chunks
+    std::vector<int16_t>    serialData(kMaxLength * 2);
+    std::vector<int16_t>    parallelData(kMaxLength * 2);
+    int16_t*    serialBuffer[] = { &serialData[0], &serialData[kMaxLength] };
+    int16_t*    parallelBuffer[] = { &parallelData[0], &parallelData[kMaxLength] };
+
+    ::srand(1);
+    int mismatches = 0;
+    for (int callback = 0; callback < 20000; ++callback)
+    {
+        if (callback == 10000)
+        {
+            //  re-commit an edited graph on both sides
+            serial.Disconnect(0, 9);
+            parallel.Disconnect(0, 9);
+            serial.Connect(4, 9);
+            parallel.Connect(4, 9);
+            TEST_CHECK(serial.Graph().Commit());
+            TEST_CHECK(parallel.Graph().Commit());
+        }
+        const int   length = 1 + ::rand() % kMaxLength;
+        serial.Graph().ProcessReplacing(NULL, serialBuffer, length);
+        parallel.Graph().ProcessReplacing(NULL, parallelBuffer, length);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                mismatches += (serialBuffer[ch][i] != parallelBuffer[ch][i]) ? 1 : 0;
+            }
+        }
+        serial.Graph().Collect();
+        parallel.Graph().Collect();
+    }
+
+    TEST_CHECK(mismatches == 0);
+    TEST_CHECK(serial.Graph().IsSettled());
+    TEST_CHECK(parallel.Graph().IsSettled());
+    TEST_CHECK(AtomicLoad32(&gHelperSteps) > 0);    //  the helper did take steps
+    ::printf("frames mismatching : %d, steps run by the helper : %d\n", mismatches, static_cast<int>(gHelperSteps));
+    return TestResult("AudioGraphTest");
+}
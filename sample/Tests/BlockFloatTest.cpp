@@ -0,0 +1,134 @@
+//
+//  BlockFloatTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Block float round trips : quantization error within half a step of the block, the
+//  vectorized block decode equal to the per-frame read, and a compressed voice rendering
+//  the decoded samples across block boundaries.
+//
+
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "DrumSample.h"
+#include "DrumSampleBlockFloat.h"
+#include "TestCheck.h"
+
+//  ---------------------------------------------------------------------------
+//      RandomSample
+//  ---------------------------------------------------------------------------
+//  24-bit sample with a random level per block, so that every shift is used (below clipping)
+static int32_t
+RandomSample(int level)
+{
+    const int32_t   range = (kBlockFloatMaxMantissa << kBlockFloatMaxShift) >> level;
+    return static_cast<int32_t>(::rand() % (2 * range + 1)) - range;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    ::srand(1);
+
+    //  single blocks : every frame within half a quantization step, decode == per-frame read
+    int maxErrorExcess = 0;
+    int decodeMismatches = 0;
+    for (int blockNo = 0; blockNo < 2000; ++blockNo)
+    {
+        const int   level = blockNo % 24;
+        const uint32_t  frames = (blockNo % 5 == 0) ? (1 + blockNo % kBlockFloatFrames) : kBlockFloatFrames;
+        int32_t src[kBlockFloatFrames * 2];
+        for (uint32_t index = 0; index < frames * 2; ++index)
+        {
+            src[index] = RandomSample(level);
+        }
+        BlockFloatBlock<2>  block;
+        BlockFloatEncode<2>(src, frames, block);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            int32_t decoded[kBlockFloatFrames];
+            BlockFloatDecode(block.low[ch], block.high[ch], block.shift[ch], decoded);
+            const int32_t   halfStep = (1 << block.shift[ch]) / 2 + 1;
+            for (uint32_t frame = 0; frame < kBlockFloatFrames; ++frame)
+            {
+                decodeMismatches += (decoded[frame] != BlockFloatSample<2>(block, ch, frame)) ? 1 : 0;
+                const int32_t   expected = (frame < frames) ? src[frame * 2 + ch] : 0;
+                const int32_t   error = ::abs(decoded[frame] - expected);
+                maxErrorExcess = (error - halfStep > maxErrorExcess) ? (error - halfStep) : maxErrorExcess;
+            }
+        }
+    }
+    TEST_CHECK(decodeMismatches == 0);
+    TEST_CHECK(maxErrorExcess <= 0);
+
+    //  a decaying drum-like tone keeps better than 16-bit PCM quality
+    const uint32_t  kFrames = 44100;
+    std::vector<int32_t>    tone(kFrames);
+    for (uint32_t frame = 0; frame < kFrames; ++frame)
+    {
+        const float t = frame / 44100.0f;
+        tone[frame] = static_cast<int32_t>(::sinf(2.0f * static_cast<float>(M_PI) * 60.0f * t) * ::expf(-t * 6.0f) * 0x7FFFFF * 0.9f);
+    }
+    std::vector<uint8_t>    packed(kFrames * 3);
+    for (uint32_t frame = 0; frame < kFrames; ++frame)
+    {
+        packed[frame * 3 + 0] = static_cast<uint8_t>(tone[frame]);
+        packed[frame * 3 + 1] = static_cast<uint8_t>(tone[frame] >> 8);
+        packed[frame * 3 + 2] = static_cast<uint8_t>(tone[frame] >> 16);
+    }
+#if defined(__BIG_ENDIAN__)
+    for (uint32_t frame = 0; frame < kFrames; ++frame)
+    {
+        SampleFormatInt24::SwapByteOrder(&packed[frame * 3]);
+    }
+#endif
+    DrumSampleData<SampleFormatInt24, 1>    raw;
+    raw.Append(&packed[0], kFrames);
+    DrumSampleBlockFloat<1> compressed(raw);
+    TEST_CHECK(compressed.GetNumberOfFrames() == kFrames);
+    TEST_CHECK(compressed.GetDataSize() * 3 < raw.GetDataSize() * 2);   //  better than 1.5:1 vs int24
+
+    std::vector<int32_t>    decoded(kFrames);
+    compressed.ReadFrames(&decoded[0], 0, kFrames);
+    double  signal = 0.0;
+    double  noise = 0.0;
+    for (uint32_t frame = 0; frame < kFrames; ++frame)
+    {
+        signal += static_cast<double>(tone[frame]) * tone[frame];
+        noise += static_cast<double>(tone[frame] - decoded[frame]) * (tone[frame] - decoded[frame]);
+    }
+    const double    snr = 10.0 * ::log10(signal / noise);
+    ::printf("block float SNR : %.1f dB\n", snr);
+    TEST_CHECK(snr > 68.0);
+
+    //  a voice at the original pitch renders the decoded samples, block after block
+    DrumDecodeCache cache;
+    cache.blockNo = -1;
+    DrumVoiceState  voice;
+    voice.currentAddress = 0;
+    voice.pitchOffset = 0x1000;
+    voice.ampCoef = 32768;
+    voice.panCoef = 0;
+    voice.isRunning = true;
+    voice.decodeCache = &cache;
+    std::vector<float>  output(kFrames);
+    const int   kBlockLength = 100;     //  not a multiple of the codec block
+    for (uint32_t frame = 0; frame < kFrames; frame += kBlockLength)
+    {
+        compressed.Render(voice, &output[frame], 1, std::min<int>(kBlockLength, kFrames - frame));
+    }
+    int renderMismatches = 0;
+    for (uint32_t frame = 0; frame < kFrames; ++frame)
+    {
+        renderMismatches += (output[frame] != static_cast<float>(decoded[frame]) / 8388608.0f) ? 1 : 0;
+    }
+    TEST_CHECK(renderMismatches == 0);
+
+    return TestResult("BlockFloatTest");
+}
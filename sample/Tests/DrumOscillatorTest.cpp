@@ -0,0 +1,97 @@
+//
+//  DrumOscillatorTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Every storage format and channel count maps to its own kernel, and the oscillator's direct
+//  kernel call renders what the virtual Render() of the sample does.
+//
+
+#include <vector>
+#include "DrumOscillator.h"
+#include "TestCheck.h"
+
+static const uint32_t   kFrames = 3000;
+
+//  ---------------------------------------------------------------------------
+//      FillSample
+//  ---------------------------------------------------------------------------
+template <class Format, int Channels>
+static DrumSampleData<Format, Channels>*
+FillSample(void)
+{
+    typedef typename Format::StorageType    StorageType;
+    std::vector<StorageType>    data(kFrames * Channels * Format::kStorageUnits);
+    for (size_t index = 0; index < data.size(); ++index)
+    {
+        data[index] = static_cast<StorageType>((index * 7919) % 251) - 125;
+    }
+    DrumSampleData<Format, Channels>*   sample = new DrumSampleData<Format, Channels>();
+    sample->Append(&data[0], kFrames);
+    return sample;
+}
+
+//  ---------------------------------------------------------------------------
+//      Compare
+//  ---------------------------------------------------------------------------
+//  oscillator output against the virtual Render() of a copy of the sample
+static void
+Compare(DrumSample* sample, DrumSample* reference, int kernel, bool compress)
+{
+    TEST_CHECK(compress || (sample->GetKernel() == kernel));
+    const int   channels = sample->GetNumberOfChannels();
+    DrumOscillator  osc(44100.0f);
+    osc.SetSample(sample, 44100.0f, compress);
+    DrumSample* expectedSample = compress ? NULL : reference;
+    if (compress)
+    {
+        expectedSample = (channels == 1) ? static_cast<DrumSample*>(new DrumSampleBlockFloat<1>(*reference))
+                                         : static_cast<DrumSample*>(new DrumSampleBlockFloat<2>(*reference));
+        TEST_CHECK(expectedSample->GetKernel() == kernel);
+        delete reference;
+    }
+
+    DrumDecodeCache cache;
+    cache.blockNo = -1;
+    DrumVoiceState  voice;
+    voice.currentAddress = 0;
+    voice.pitchOffset = 0x1000;
+    voice.ampCoef = 0x7FFF >> 2;
+    voice.panCoef = 0;
+    voice.isRunning = true;
+    voice.decodeCache = &cache;
+
+    const int   kStride = 16;
+    const int   kBlockLength = 100;
+    std::vector<float>  output((kFrames + kBlockLength) * kStride, 0.0f);
+    std::vector<float>  expected((kFrames + kBlockLength) * kStride, 0.0f);
+    osc.TriggerOn();
+    for (uint32_t frame = 0; frame <= kFrames; frame += kBlockLength)   //  one block past the end
+    {
+        osc.Process(&output[frame * kStride], kStride, kBlockLength);
+        expectedSample->Render(voice, &expected[frame * kStride], kStride, kBlockLength);
+    }
+    TEST_CHECK(output == expected);
+    TEST_CHECK(!osc.IsActive());
+    delete expectedSample;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    Compare(FillSample<SampleFormatInt16, 1>(), FillSample<SampleFormatInt16, 1>(), kDrumKernel_Int16, false);
+    Compare(FillSample<SampleFormatInt16, 2>(), FillSample<SampleFormatInt16, 2>(), kDrumKernel_Int16 + 1, false);
+    Compare(FillSample<SampleFormatInt24, 1>(), FillSample<SampleFormatInt24, 1>(), kDrumKernel_Int24, false);
+    Compare(FillSample<SampleFormatInt24, 2>(), FillSample<SampleFormatInt24, 2>(), kDrumKernel_Int24 + 1, false);
+    Compare(FillSample<SampleFormatFloat32, 1>(), FillSample<SampleFormatFloat32, 1>(), kDrumKernel_Float32, false);
+    Compare(FillSample<SampleFormatFloat32, 2>(), FillSample<SampleFormatFloat32, 2>(), kDrumKernel_Float32 + 1, false);
+    Compare(FillSample<SampleFormatInt16, 1>(), FillSample<SampleFormatInt16, 1>(), kDrumKernel_BlockFloat, true);
+    Compare(FillSample<SampleFormatInt24, 2>(), FillSample<SampleFormatInt24, 2>(), kDrumKernel_BlockFloat + 1, true);
+
+    return TestResult("DrumOscillatorTest");
+}
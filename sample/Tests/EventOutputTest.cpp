@@ -0,0 +1,169 @@
+//
+//  EventOutputTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Loopback of the output event stream : a Synthesizer rendered by the AudioIO of the host
+//  tests on a virtual output clock, its events collected by a sink. Start, clocks, notes and
+//  stop come out in order, stamped with the output time of their frame, with and without
+//  look-ahead. Linux only, AudioIOHost.cpp stands in for the device.
+//
+
+#include <math.h>
+#include <unistd.h>
+#include <vector>
+#include "Synthesizer.h"
+#include "EventOutput.h"
+#include "TestCheck.h"
+
+static const float  kSamplingRate = 44100.0f;
+static const int    kBufferLength = 256;
+static const double kTempo = 120.0;
+static const double kClockNano = 60.0e9 / kTempo / 24;
+static const double kToleranceNano = 2.0e9 / kSamplingRate;     //  two frames
+
+//
+//  AudioIO rendered by the test, one buffer per Tick()
+//
+class LoopbackIO : public AudioIO
+{
+public:
+    LoopbackIO(float samplingRate) : AudioIO(samplingRate), data_(kBufferLength * 2) {}
+
+    void    Tick(uint64_t hostTime)
+    {
+        AudioTimeStamp  timeStamp;
+        timeStamp.mSampleTime = 0;
+        timeStamp.mHostTime = hostTime;
+        timeStamp.mFlags = kAudioTimeStampHostTimeValid;
+        AudioBufferList list;
+        list.mNumberBuffers = 1;
+        list.mBuffers[0].mNumberChannels = 2;
+        list.mBuffers[0].mDataByteSize = static_cast<UInt32>(data_.size() * sizeof(int16_t));
+        list.mBuffers[0].mData = &data_[0];
+        this->Render(NULL, &timeStamp, 0, kBufferLength, &list);
+    }
+
+private:
+    std::vector<int16_t>    data_;
+};
+
+//
+//  keeps every event, read once the output is stopped
+//
+class RecordingSink : public EventSink
+{
+public:
+    void    Send(const OutputEvent* events, int numberOfEvents)
+    {
+        events_.insert(events_.end(), events, events + numberOfEvents);
+    }
+
+    std::vector<OutputEvent>    events_;
+};
+
+//  ---------------------------------------------------------------------------
+//      IsNear
+//  ---------------------------------------------------------------------------
+static bool
+IsNear(uint64_t hostTime, double expectedNano)
+{
+    return ::fabs(static_cast<double>(hostTime) - expectedNano) <= kToleranceNano;
+}
+
+//  ---------------------------------------------------------------------------
+//      Loopback
+//  ---------------------------------------------------------------------------
+static void
+Loopback(bool lookAhead)
+{
+    //  the host time of the host tests is in nanoseconds
+    const uint64_t  origin = 1000000000ULL;
+    const uint64_t  startTime = origin + 100000000ULL;
+    const uint64_t  stopTime = startTime + static_cast<uint64_t>(kClockNano * 96 + 1000000.0);    //  just after clock 96
+
+    Synthesizer synth(kSamplingRate);
+    synth.SetLookAheadMode(lookAhead);
+    TEST_CHECK(synth.IsLookAheadMode() == lookAhead);
+    RecordingSink   sink;
+    EventOutput output;
+    output.SetSink(&sink);
+    synth.SetEventOutput(&output);
+    TEST_CHECK(output.Start());
+    LoopbackIO  io(kSamplingRate);
+    io.SetListener(&synth);
+    const double    latency = static_cast<double>(io.GetLatency());
+    TEST_CHECK(latency > 0.0);
+
+    synth.StartSequence(startTime, static_cast<float>(kTempo));
+    synth.StopSequence(stopTime);
+    for (int bufferNo = 0; bufferNo < 2.5 * kSamplingRate / kBufferLength; ++bufferNo)
+    {
+        io.Tick(origin + static_cast<uint64_t>(bufferNo * kBufferLength * 1.0e9 / kSamplingRate));
+        if (lookAhead)
+        {
+            ::usleep(1000);     //  give the worker the time a real device would
+        }
+    }
+    output.Stop();
+    TEST_CHECK(output.GetDroppedCount() == 0);
+    TEST_CHECK(synth.GetLookAheadUnderrunCount() == 0);
+
+    const std::vector<OutputEvent>& events = sink.events_;
+    TEST_CHECK(events.size() > 2);
+    if (events.size() <= 2)
+    {
+        return;
+    }
+    TEST_CHECK(events.front().type == kOutputEvent_Start);
+    TEST_CHECK(events.back().type == kOutputEvent_Stop);
+    TEST_CHECK(IsNear(events.front().hostTime, startTime + latency));
+    TEST_CHECK(IsNear(events.back().hostTime, stopTime + latency));
+
+    //  clock n at start + n / 24 beat, the notes of track 3 (every step) on every 6th clock
+    const double    startNano = static_cast<double>(events.front().hostTime);
+    int clocks = 0;
+    int notes = 0;
+    int unordered = 0;
+    int offClock = 0;
+    int offStep = 0;
+    for (size_t index = 0; index < events.size(); ++index)
+    {
+        const OutputEvent&  event = events[index];
+        if ((index > 0) && (event.hostTime < events[index - 1].hostTime))
+        {
+            ++unordered;
+        }
+        if (event.type == kOutputEvent_Clock)
+        {
+            offClock += IsNear(event.hostTime, startNano + clocks * kClockNano) ? 0 : 1;
+            ++clocks;
+        }
+        else if ((event.type == kOutputEvent_Note) && (event.value == 3))
+        {
+            offStep += IsNear(event.hostTime, startNano + notes * Sequencer::kClocksPerStep * kClockNano) ? 0 : 1;
+            ++notes;
+        }
+    }
+    ::printf("%s : %d events, %d clocks, %d notes of track 3\n", lookAhead ? "look-ahead" : "direct",
+             static_cast<int>(events.size()), clocks, notes);
+    TEST_CHECK(unordered == 0);
+    TEST_CHECK(clocks == 97);
+    TEST_CHECK(offClock == 0);
+    TEST_CHECK(notes == 17);
+    TEST_CHECK(offStep == 0);
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    Loopback(false);
+    Loopback(true);
+
+    return TestResult("EventOutputTest");
+}
@@ -0,0 +1,179 @@
+//
+//  Accelerate.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : the vDSP calls of SpectrumAnalyzer, plain loops with the vDSP packing
+//  and scaling (the forward real FFT returns 2x the DFT, Nyquist in imagp[0]).
+//
+
+#pragma once
+
+#include <stdlib.h>
+#include <math.h>
+
+typedef unsigned long   vDSP_Length;
+typedef long            vDSP_Stride;
+typedef int             FFTDirection;
+typedef int             FFTRadix;
+
+typedef struct {
+    float   real;
+    float   imag;
+} DSPComplex;
+
+typedef struct {
+    float*  realp;
+    float*  imagp;
+} DSPSplitComplex;
+
+typedef struct OpaqueFFTSetup {
+    vDSP_Length log2n;
+}* FFTSetup;
+
+enum
+{
+    kFFTRadix2 = 0,
+    FFT_FORWARD = 1,
+};
+
+//  ---------------------------------------------------------------------------
+//      vDSP_create_fftsetup
+//  ---------------------------------------------------------------------------
+static inline FFTSetup
+vDSP_create_fftsetup(vDSP_Length log2n, FFTRadix /*radix*/)
+{
+    FFTSetup    setup = static_cast<FFTSetup>(::malloc(sizeof(*setup)));
+    setup->log2n = log2n;
+    return setup;
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_destroy_fftsetup
+//  ---------------------------------------------------------------------------
+static inline void
+vDSP_destroy_fftsetup(FFTSetup setup)
+{
+    ::free(setup);
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_vmul
+//  ---------------------------------------------------------------------------
+static inline void
+vDSP_vmul(const float* a, vDSP_Stride strideA, const float* b, vDSP_Stride strideB, float* c, vDSP_Stride strideC, vDSP_Length length)
+{
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        c[index * strideC] = a[index * strideA] * b[index * strideB];
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_vsmul
+//  ---------------------------------------------------------------------------
+static inline void
+vDSP_vsmul(const float* a, vDSP_Stride strideA, const float* scalar, float* c, vDSP_Stride strideC, vDSP_Length length)
+{
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        c[index * strideC] = a[index * strideA] * *scalar;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_ctoz
+//  ---------------------------------------------------------------------------
+static inline void
+vDSP_ctoz(const DSPComplex* c, vDSP_Stride strideC, const DSPSplitComplex* z, vDSP_Stride strideZ, vDSP_Length length)
+{
+    //  strideC counts floats of interleaved pairs, as in vDSP
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        z->realp[index * strideZ] = c[index * strideC / 2].real;
+        z->imagp[index * strideZ] = c[index * strideC / 2].imag;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_fft_zrip
+//  ---------------------------------------------------------------------------
+//  in place forward real FFT of 2^log2n samples packed as even / odd pairs
+static inline void
+vDSP_fft_zrip(FFTSetup /*setup*/, const DSPSplitComplex* z, vDSP_Stride /*stride*/, vDSP_Length log2n, FFTDirection /*direction*/)
+{
+    const vDSP_Length   length = 1UL << log2n;
+    const vDSP_Length   half = length / 2;
+    double* re = static_cast<double*>(::malloc(length * sizeof(double)));
+    double* im = static_cast<double*>(::malloc(length * sizeof(double)));
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        //  bit reversed order
+        vDSP_Length reversed = 0;
+        for (vDSP_Length bit = 0; bit < log2n; ++bit)
+        {
+            reversed |= ((index >> bit) & 1) << (log2n - 1 - bit);
+        }
+        re[reversed] = (index % 2 == 0) ? z->realp[index / 2] : z->imagp[index / 2];
+        im[reversed] = 0.0;
+    }
+    for (vDSP_Length size = 2; size <= length; size *= 2)
+    {
+        const double    step = -2.0 * M_PI / size;
+        for (vDSP_Length start = 0; start < length; start += size)
+        {
+            for (vDSP_Length k = 0; k < size / 2; ++k)
+            {
+                const double    wr = ::cos(step * k);
+                const double    wi = ::sin(step * k);
+                const vDSP_Length   even = start + k;
+                const vDSP_Length   odd = even + size / 2;
+                const double    tr = re[odd] * wr - im[odd] * wi;
+                const double    ti = re[odd] * wi + im[odd] * wr;
+                re[odd] = re[even] - tr;
+                im[odd] = im[even] - ti;
+                re[even] += tr;
+                im[even] += ti;
+            }
+        }
+    }
+    z->realp[0] = static_cast<float>(2.0 * re[0]);
+    z->imagp[0] = static_cast<float>(2.0 * re[half]);
+    for (vDSP_Length bin = 1; bin < half; ++bin)
+    {
+        z->realp[bin] = static_cast<float>(2.0 * re[bin]);
+        z->imagp[bin] = static_cast<float>(2.0 * im[bin]);
+    }
+    ::free(im);
+    ::free(re);
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_zvmags
+//  ---------------------------------------------------------------------------
+static inline void
+vDSP_zvmags(const DSPSplitComplex* z, vDSP_Stride strideZ, float* c, vDSP_Stride strideC, vDSP_Length length)
+{
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        const float real = z->realp[index * strideZ];
+        const float imag = z->imagp[index * strideZ];
+        c[index * strideC] = real * real + imag * imag;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      vDSP_vdbcon
+//  ---------------------------------------------------------------------------
+//  flag 0 : power (10 log10), 1 : amplitude (20 log10)
+static inline void
+vDSP_vdbcon(const float* a, vDSP_Stride strideA, const float* reference, float* c, vDSP_Stride strideC, vDSP_Length length, unsigned int flag)
+{
+    const float factor = (flag != 0) ? 20.0f : 10.0f;
+    for (vDSP_Length index = 0; index < length; ++index)
+    {
+        c[index * strideC] = factor * ::log10f(a[index * strideA] / *reference);
+    }
+}
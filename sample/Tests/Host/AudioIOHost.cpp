@@ -0,0 +1,191 @@
+//
+//  AudioIOHost.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : AudioIO of AudioIO.mm without RemoteIO. There is no device, the test
+//  calls Render() from a subclass with the time stamps of a virtual output clock; the
+//  latency is the I/O buffer duration, as the hardware would grant it.
+//
+
+#include <mach/mach_time.h>
+#include "AudioIO.h"
+
+enum
+{
+    kDefaultIOBufferSize = 1024,
+    kMinLowLatencyIOBufferSize = 32,
+    kMaxLowLatencyIOBufferSize = 64,
+};
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::AudioIO
+//  ---------------------------------------------------------------------------
+AudioIO::AudioIO(float samplingRate) :
+listener_(NULL),
+bufferLength_(4096),
+numberOfOutputBus_(2),
+sampleRate_(samplingRate),
+ioBufferSize_(kDefaultIOBufferSize),
+isLowLatencyMode_(false),
+remoteIOUnit_(NULL),
+auGraph_(NULL),
+isRunning_(false),
+dataBuffer_(),
+outputBuffer_(),
+hostTime_(0),
+latency_(0),
+timebaseNumer_(1),
+timebaseDenom_(1)
+{
+    mach_timebase_info_data_t   timeInfo;
+    if (::mach_timebase_info(&timeInfo) == KERN_SUCCESS)
+    {
+        timebaseNumer_ = timeInfo.numer;
+        timebaseDenom_ = timeInfo.denom;
+    }
+
+    dataBuffer_.assign(bufferLength_ * numberOfOutputBus_, 0);
+    outputBuffer_.clear();
+    for (uint32_t ch = 0; ch < numberOfOutputBus_; ++ch)
+    {
+        outputBuffer_.push_back(&dataBuffer_[bufferLength_ * ch]);
+    }
+    this->SetIOBufferSize();
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::~AudioIO
+//  ---------------------------------------------------------------------------
+AudioIO::~AudioIO(void)
+{
+    this->Stop();
+    this->Close();
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::Open
+//  ---------------------------------------------------------------------------
+bool
+AudioIO::Open(void)
+{
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::Close
+//  ---------------------------------------------------------------------------
+bool
+AudioIO::Close(void)
+{
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::Start
+//  ---------------------------------------------------------------------------
+bool
+AudioIO::Start(void)
+{
+    isRunning_ = true;
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::Stop
+//  ---------------------------------------------------------------------------
+bool
+AudioIO::Stop(void)
+{
+    isRunning_ = false;
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::IsRunning
+//  ---------------------------------------------------------------------------
+bool
+AudioIO::IsRunning(void) const
+{
+    return isRunning_;
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::SetIOBufferSize
+//  ---------------------------------------------------------------------------
+void
+AudioIO::SetIOBufferSize(void)
+{
+    const Float32   duration = static_cast<float>(ioBufferSize_) / sampleRate_;
+    AtomicStore64(&latency_, static_cast<int64_t>(duration * 1000000000ULL));
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::SetLowLatencyMode
+//  ---------------------------------------------------------------------------
+void
+AudioIO::SetLowLatencyMode(bool enable, uint32_t frames)
+{
+#define CLIP(x, min, max)   (x < min ? min : (x > max ? max : x))
+    isLowLatencyMode_ = enable;
+    ioBufferSize_ = enable ? CLIP(frames, static_cast<uint32_t>(kMinLowLatencyIOBufferSize), static_cast<uint32_t>(kMaxLowLatencyIOBufferSize))
+                           : static_cast<uint32_t>(kDefaultIOBufferSize);
+    this->SetIOBufferSize();
+#undef CLIP
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::Render
+//  ---------------------------------------------------------------------------
+void
+AudioIO::Render(AudioUnitRenderActionFlags* /*ioActionFlags*/, const AudioTimeStamp* inTimeStamp, UInt32 /*inBusNumber*/,
+                UInt32 inNumberFrames, AudioBufferList* ioData)
+{
+    uint64_t    hostTime = 0;
+    if ((inTimeStamp != NULL) && ((inTimeStamp->mFlags & kAudioTimeStampHostTimeValid) != 0))
+    {
+        hostTime = inTimeStamp->mHostTime;
+    }
+    AtomicStore64(&hostTime_, static_cast<int64_t>(hostTime));
+
+    //  render
+    if (listener_ != NULL)
+    {
+        AudioSampleType*    dataBufPtr = reinterpret_cast<AudioSampleType*>(ioData->mBuffers[0].mData);
+        uint32_t    rest = inNumberFrames;
+        while (rest > 0)
+        {
+            const uint32_t  processLength = (rest < bufferLength_) ? rest : bufferLength_;
+            listener_->ProcessReplacing(this, &outputBuffer_[0], processLength);
+            for (uint32_t bus = 0; bus < numberOfOutputBus_; ++bus)
+            {
+                const int16_t*  srcPtr = outputBuffer_[bus];
+                AudioSampleType*    destPtr = dataBufPtr + bus;
+                for (uint32_t i = 0; i < processLength; ++i, destPtr += numberOfOutputBus_, ++srcPtr)
+                {
+                    *destPtr = *srcPtr;
+                }
+            }
+            rest -= processLength;
+            dataBufPtr += processLength * numberOfOutputBus_;
+
+            if ((rest > 0) && (hostTime != 0))
+            {
+                const uint64_t  timeNano = static_cast<uint64_t>(static_cast<float>(processLength) * 1000000000ULL / sampleRate_);
+                hostTime += timeNano * timebaseDenom_ / timebaseNumer_;
+                AtomicStore64(&hostTime_, static_cast<int64_t>(hostTime));
+            }
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      AudioIO::SetListener
+//  ---------------------------------------------------------------------------
+void
+AudioIO::SetListener(AudioIOListener* listener)
+{
+    listener_ = listener;
+}
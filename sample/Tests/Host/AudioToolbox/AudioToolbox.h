@@ -0,0 +1,48 @@
+//
+//  AudioToolbox.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : the AudioToolbox types AudioIO.h declares, so that AudioIOListener
+//  implementations can be built on Linux. AudioIO itself is replaced by AudioIOHost.cpp.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t     OSStatus;
+typedef float       Float32;
+typedef double      Float64;
+typedef uint32_t    UInt32;
+typedef uint64_t    UInt64;
+typedef int16_t     AudioSampleType;
+typedef UInt32      AudioUnitRenderActionFlags;
+typedef UInt32      AudioSessionPropertyID;
+typedef struct OpaqueAudioComponentInstance*    AudioUnit;
+typedef struct OpaqueAUGraph*   AUGraph;
+
+enum
+{
+    noErr = 0,
+    kAudioTimeStampHostTimeValid = (1U << 1),
+};
+
+typedef struct {
+    Float64     mSampleTime;
+    UInt64      mHostTime;
+    UInt32      mFlags;
+} AudioTimeStamp;
+
+typedef struct {
+    UInt32      mNumberChannels;
+    UInt32      mDataByteSize;
+    void*       mData;
+} AudioBuffer;
+
+typedef struct {
+    UInt32      mNumberBuffers;
+    AudioBuffer mBuffers[1];
+} AudioBufferList;
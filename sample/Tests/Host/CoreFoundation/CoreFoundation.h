@@ -0,0 +1,15 @@
+//
+//  CoreFoundation.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : CFStringRef names the sample files, it is a plain C string here.
+//
+
+#pragma once
+
+typedef const struct __CFString*    CFStringRef;
+
+#define CFSTR(cstr)     (reinterpret_cast<CFStringRef>(cstr))
@@ -0,0 +1,110 @@
+//
+//  DrumOscillatorHost.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : the sample loader of DrumOscillator.mm without AudioToolbox. Reads the
+//  PCM WAV files of ../Resources/wav (16 / 24-bit integer, 32-bit float, mono or stereo).
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "DrumOscillator.h"
+
+static const char*  kResourceFolder = "../Resources/wav/";
+
+//  ---------------------------------------------------------------------------
+//      ReadLE
+//  ---------------------------------------------------------------------------
+static uint32_t
+ReadLE(const uint8_t* src, int bytes)
+{
+    uint32_t    value = 0;
+    for (int index = bytes - 1; index >= 0; --index)
+    {
+        value = (value << 8) | src[index];
+    }
+    return value;
+}
+
+//  ---------------------------------------------------------------------------
+//      CreateDrumSample
+//  ---------------------------------------------------------------------------
+template <int Channels>
+static DrumSampleBuilder*
+CreateDrumSample(uint32_t formatTag, uint32_t bitsPerSample)
+{
+    if ((formatTag == 3) && (bitsPerSample == SampleFormatFloat32::kBitsPerSample))
+    {
+        return new DrumSampleData<SampleFormatFloat32, Channels>();
+    }
+    else if ((formatTag == 1) && (bitsPerSample == SampleFormatInt16::kBitsPerSample))
+    {
+        return new DrumSampleData<SampleFormatInt16, Channels>();
+    }
+    else if ((formatTag == 1) && (bitsPerSample == SampleFormatInt24::kBitsPerSample))
+    {
+        return new DrumSampleData<SampleFormatInt24, Channels>();
+    }
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      DrumOscillator::LoadAudioFileInResourceFolder
+//  ---------------------------------------------------------------------------
+void
+DrumOscillator::LoadAudioFileInResourceFolder(CFStringRef path, bool compress)
+{
+    DrumSampleBuilder*  builder = NULL;
+    float   samplingRate = tgSamlingRate_;
+    std::vector<uint8_t>    file;
+    FILE*   fp = ::fopen((std::string(kResourceFolder) + reinterpret_cast<const char*>(path)).c_str(), "rb");
+    if (fp != NULL)
+    {
+        uint8_t buffer[4096];
+        size_t  bytes;
+        while ((bytes = ::fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        {
+            file.insert(file.end(), buffer, buffer + bytes);
+        }
+        ::fclose(fp);
+    }
+    if ((file.size() >= 12) && (::memcmp(&file[0], "RIFF", 4) == 0) && (::memcmp(&file[8], "WAVE", 4) == 0))
+    {
+        uint32_t    blockAlign = 0;
+        size_t  pos = 12;
+        while (pos + 8 <= file.size())
+        {
+            const uint8_t*  chunk = &file[pos];
+            const uint32_t  chunkSize = std::min<uint32_t>(ReadLE(chunk + 4, 4), file.size() - pos - 8);
+            if ((::memcmp(chunk, "fmt ", 4) == 0) && (chunkSize >= 16))
+            {
+                const uint32_t  formatTag = ReadLE(chunk + 8, 2);
+                const uint32_t  channels = ReadLE(chunk + 10, 2);
+                const uint32_t  bitsPerSample = ReadLE(chunk + 22, 2);
+                samplingRate = static_cast<float>(ReadLE(chunk + 12, 4));
+                blockAlign = ReadLE(chunk + 20, 2);
+                delete builder;
+                builder = (channels == 1) ? CreateDrumSample<1>(formatTag, bitsPerSample) :
+                          (channels == 2) ? CreateDrumSample<2>(formatTag, bitsPerSample) : NULL;
+            }
+            else if ((::memcmp(chunk, "data", 4) == 0) && (builder != NULL) && (blockAlign != 0))
+            {
+                builder->Append(chunk + 8, chunkSize / blockAlign);
+            }
+            pos += 8 + ((chunkSize + 1) & ~1);
+        }
+#if defined(__BIG_ENDIAN__)
+        if (builder != NULL)
+        {
+            builder->SwapByteOrder();
+        }
+#endif
+    }
+    this->SetSample(builder, samplingRate, compress);
+}
@@ -0,0 +1,19 @@
+//
+//  kern_return.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only, see semaphore.h.
+//
+
+#pragma once
+
+typedef int     kern_return_t;
+
+enum
+{
+    KERN_SUCCESS = 0,
+    KERN_OPERATION_TIMED_OUT = 49,
+};
@@ -0,0 +1,14 @@
+//
+//  mach.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only, see semaphore.h.
+//
+
+#pragma once
+
+#include <mach/semaphore.h>
+#include <mach/mach_time.h>
@@ -0,0 +1,36 @@
+//
+//  mach_time.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : host time in nanoseconds (timebase 1/1) from the monotonic clock.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <mach/kern_return.h>
+
+typedef struct {
+    uint32_t    numer;
+    uint32_t    denom;
+} mach_timebase_info_data_t;
+
+static inline kern_return_t
+mach_timebase_info(mach_timebase_info_data_t* info)
+{
+    info->numer = 1;
+    info->denom = 1;
+    return KERN_SUCCESS;
+}
+
+static inline uint64_t
+mach_absolute_time(void)
+{
+    struct timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
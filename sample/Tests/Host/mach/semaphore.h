@@ -0,0 +1,90 @@
+//
+//  semaphore.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Host tests only : the mach semaphore calls of the engine on top of POSIX semaphores,
+//  so that the lock-free parts can be tested on Linux. Not used on Apple platforms.
+//
+
+#pragma once
+
+#include <semaphore.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include <mach/kern_return.h>
+
+typedef sem_t*  semaphore_t;
+typedef int     task_t;
+typedef int     clock_res_t;
+
+typedef struct {
+    unsigned int    tv_sec;
+    clock_res_t     tv_nsec;
+} mach_timespec_t;
+
+enum
+{
+    SYNC_POLICY_FIFO = 0,
+};
+
+static inline task_t
+mach_task_self(void)
+{
+    return 0;
+}
+
+static inline kern_return_t
+semaphore_create(task_t, semaphore_t* semaphore, int, int value)
+{
+    *semaphore = static_cast<sem_t*>(::malloc(sizeof(sem_t)));
+    return ::sem_init(*semaphore, 0, value);
+}
+
+static inline kern_return_t
+semaphore_destroy(task_t, semaphore_t semaphore)
+{
+    ::sem_destroy(semaphore);
+    ::free(semaphore);
+    return KERN_SUCCESS;
+}
+
+static inline kern_return_t
+semaphore_signal(semaphore_t semaphore)
+{
+    return ::sem_post(semaphore);
+}
+
+static inline kern_return_t
+semaphore_wait(semaphore_t semaphore)
+{
+    while (::sem_wait(semaphore) != 0)
+    {
+    }
+    return KERN_SUCCESS;
+}
+
+static inline kern_return_t
+semaphore_timedwait(semaphore_t semaphore, mach_timespec_t wait)
+{
+    struct timespec deadline;
+    ::clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += wait.tv_sec;
+    deadline.tv_nsec += wait.tv_nsec;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+    }
+    while (::sem_timedwait(semaphore, &deadline) != 0)
+    {
+        if (errno == ETIMEDOUT)
+        {
+            return KERN_OPERATION_TIMED_OUT;
+        }
+    }
+    return KERN_SUCCESS;
+}
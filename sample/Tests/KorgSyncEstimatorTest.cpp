@@ -0,0 +1,146 @@
+//
+//  KorgSyncEstimatorTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Symmetric beacons give the clock offset exactly, whatever the time spent in the peer;
+//  beacons with long asymmetric round trips are left out; impossible stamps are rejected.
+//  The beacon rate follows the burst and the spread of the best offsets.
+//
+
+#include <math.h>
+#include "KorgSyncEstimator.h"
+#include "TestCheck.h"
+
+static const double     kOffsetNano = 123456789.0;
+static const uint64_t   kBurstNano = 20000000ULL;
+static const uint64_t   kSettleNano = 50000000ULL;
+static const uint64_t   kStableNano = 250000000ULL;
+
+//  ---------------------------------------------------------------------------
+//      AddBeacon
+//  ---------------------------------------------------------------------------
+//  sent at sentNano, up / down one way delays and the time spent in the peer
+static int
+AddBeacon(KorgSyncEstimator* estimator, uint64_t sentNano, uint64_t upNano, uint64_t downNano, uint64_t remoteNano)
+{
+    const uint64_t  remoteReceivedNano = static_cast<uint64_t>(sentNano + upNano + kOffsetNano);
+    const uint64_t  remoteSentNano = remoteReceivedNano + remoteNano;
+    const uint64_t  receivedNano = sentNano + upNano + remoteNano + downNano;
+    return KorgSyncEstimatorAddBeacon(estimator, sentNano, remoteReceivedNano, remoteSentNano, receivedNano);
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    KorgSyncEstimator   estimator;
+
+    //  symmetric : exact from the first beacon, stable once the window is full
+    {
+        KorgSyncEstimatorReset(&estimator);
+        TEST_CHECK(!estimator.beaconReceived);
+        TEST_CHECK(KorgSyncEstimatorBeaconInterval(&estimator) == kBurstNano);
+        uint64_t    nowNano = 1000000000ULL;
+        int errors = 0;
+        for (int beaconNo = 0; beaconNo < kKorgSyncWindow; ++beaconNo)
+        {
+            TEST_CHECK(!KorgSyncEstimatorIsStable(&estimator));
+            errors += AddBeacon(&estimator, nowNano, 4000000ULL, 4000000ULL, 500000ULL + beaconNo * 100000ULL) ? 0 : 1;
+            errors += (::fabs(estimator.timeDiff - kOffsetNano) > 1.0) ? 1 : 0;
+            nowNano += KorgSyncEstimatorBeaconInterval(&estimator);
+        }
+        TEST_CHECK(errors == 0);
+        TEST_CHECK(estimator.beaconReceived);
+        TEST_CHECK(estimator.worstDelay == 4000000ULL);     //  the time in the peer is not a delay
+        TEST_CHECK(KorgSyncEstimatorIsStable(&estimator));
+        TEST_CHECK(KorgSyncEstimatorBeaconInterval(&estimator) == kBurstNano);     //  24 beacons of burst
+        for (int beaconNo = kKorgSyncWindow; beaconNo < kKorgSyncBurstBeacons; ++beaconNo)
+        {
+            AddBeacon(&estimator, nowNano, 4000000ULL, 4000000ULL, 500000ULL);
+            nowNano += kBurstNano;
+        }
+        TEST_CHECK(KorgSyncEstimatorBeaconInterval(&estimator) == kStableNano);
+        TEST_CHECK(KorgSyncEstimatorToRemote(&estimator, 1000000000ULL) == 1000000000ULL + static_cast<uint64_t>(kOffsetNano));
+
+        KorgSyncEstimatorRequestBurst(&estimator);
+        TEST_CHECK(KorgSyncEstimatorIsStable(&estimator));
+        TEST_CHECK(KorgSyncEstimatorBeaconInterval(&estimator) == kBurstNano);
+    }
+
+    //  a peer that stamps only when it sends : its time in between counts as delay
+    {
+        KorgSyncEstimatorReset(&estimator);
+        const uint64_t  sentNano = 1000000000ULL;
+        const uint64_t  remoteNano = static_cast<uint64_t>(sentNano + 5000000ULL + kOffsetNano);
+        TEST_CHECK(KorgSyncEstimatorAddBeacon(&estimator, sentNano, remoteNano, remoteNano, sentNano + 10000000ULL));
+        TEST_CHECK(::fabs(estimator.timeDiff - kOffsetNano) <= 1.0);
+        TEST_CHECK(estimator.worstDelay == 5000000ULL);
+    }
+
+    //  every third beacon 40 ms late one way : never among the best round trips once there are
+    //  enough others
+    {
+        KorgSyncEstimatorReset(&estimator);
+        uint64_t    nowNano = 1000000000ULL;
+        int errors = 0;
+        for (int beaconNo = 0; beaconNo < 100; ++beaconNo)
+        {
+            const bool  isLate = ((beaconNo % 3) == 1);
+            AddBeacon(&estimator, nowNano, isLate ? 44000000ULL : 4000000ULL, 4000000ULL, 1000000ULL);
+            if (beaconNo >= kKorgSyncBestSamples + 2)
+            {
+                errors += (::fabs(estimator.timeDiff - kOffsetNano) > 1.0) ? 1 : 0;
+            }
+            nowNano += KorgSyncEstimatorBeaconInterval(&estimator);
+        }
+        TEST_CHECK(errors == 0);
+        TEST_CHECK(estimator.jitter < 1.0);
+        TEST_CHECK(KorgSyncEstimatorIsStable(&estimator));
+        TEST_CHECK(estimator.worstDelay == 24000000ULL);
+    }
+
+    //  equal round trips split 2 / 6 ms and 6 / 2 ms : the best offsets spread by 4 ms, not stable
+    {
+        KorgSyncEstimatorReset(&estimator);
+        for (int beaconNo = 0; beaconNo < 40; ++beaconNo)
+        {
+            const bool  isEven = ((beaconNo % 2) == 0);
+            AddBeacon(&estimator, 1000000000ULL + beaconNo * kSettleNano, isEven ? 2000000ULL : 6000000ULL,
+                      isEven ? 6000000ULL : 2000000ULL, 1000000ULL);
+        }
+        TEST_CHECK(::fabs(estimator.jitter - 4000000.0) <= 1.0);
+        TEST_CHECK(::fabs(estimator.timeDiff - kOffsetNano) <= 2000000.0);
+        TEST_CHECK(!KorgSyncEstimatorIsStable(&estimator));
+        TEST_CHECK(KorgSyncEstimatorBeaconInterval(&estimator) == kSettleNano);
+    }
+
+    //  rejected : received before sent, a one way delay of 4 sec or more; nothing is changed
+    {
+        KorgSyncEstimatorReset(&estimator);
+        TEST_CHECK(AddBeacon(&estimator, 1000000000ULL, 3000000ULL, 3000000ULL, 0));
+        const KorgSyncEstimator saved = estimator;
+        TEST_CHECK(!KorgSyncEstimatorAddBeacon(&estimator, 2000000000ULL, 3000000000ULL, 3000000000ULL, 1000000000ULL));
+        TEST_CHECK(!AddBeacon(&estimator, 3000000000ULL, 4000000000ULL, 4000000000ULL, 0));
+        TEST_CHECK(estimator.numberOfSamples == saved.numberOfSamples);
+        TEST_CHECK(estimator.worstDelay == saved.worstDelay);
+        TEST_CHECK(estimator.timeDiff == saved.timeDiff);
+        TEST_CHECK(estimator.burstRemaining == saved.burstRemaining);
+    }
+
+    //  reset : back to no beacon and a burst
+    {
+        KorgSyncEstimatorReset(&estimator);
+        TEST_CHECK(!estimator.beaconReceived);
+        TEST_CHECK(estimator.numberOfSamples == 0);
+        TEST_CHECK(estimator.worstDelay == 0);
+        TEST_CHECK(estimator.burstRemaining == kKorgSyncBurstBeacons);
+        TEST_CHECK(!KorgSyncEstimatorIsStable(&estimator));
+    }
+
+    return TestResult("KorgSyncEstimatorTest");
+}
@@ -0,0 +1,176 @@
+//
+//  KorgSyncTraceTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  The trace file holds a valid header, then every appended record once, in the order of
+//  their record numbers, while several threads append and another one flushes. A full ring
+//  drops records and the next flush writes how many.
+//
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+#include "KorgSyncTrace.h"
+#include "AtomicOps.h"
+#include "TestCheck.h"
+
+static const int    kWriters = 3;
+static const int    kRecordsPerWriter = 20000;
+
+typedef struct {
+    KorgSyncTrace*  trace;
+    int             writerNo;
+    volatile int32_t    isDone;
+} Writer;
+
+//  ---------------------------------------------------------------------------
+//      Write
+//  ---------------------------------------------------------------------------
+//  value : writer number, record number of the writer; the ring is never full for long
+static void*
+Write(void* arg)
+{
+    Writer* writer = reinterpret_cast<Writer*>(arg);
+    for (int recordNo = 0; recordNo < kRecordsPerWriter; ++recordNo)
+    {
+        KorgSyncTraceAppend(writer->trace, recordNo, kKorgSyncTrace_Beacon, writer->writerNo, recordNo, 0, -1);
+        if ((recordNo % 64) == 63)
+        {
+            ::sched_yield();
+        }
+    }
+    AtomicStore32(&writer->isDone, 1);
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      ReadTrace
+//  ---------------------------------------------------------------------------
+static bool
+ReadTrace(const char* path, std::vector<KorgSyncTraceRecord>& records)
+{
+    FILE*   file = ::fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    KorgSyncTraceHeader header;
+    const bool  isValid = (::fread(&header, sizeof(header), 1, file) == 1) && (header.magic == kKorgSyncTraceMagic)
+                            && (header.version == kKorgSyncTraceVersion) && (header.recordSize == sizeof(KorgSyncTraceRecord));
+    KorgSyncTraceRecord record;
+    while (isValid && (::fread(&record, sizeof(record), 1, file) == 1))
+    {
+        records.push_back(record);
+    }
+    ::fclose(file);
+    return isValid;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    char    path[] = "/tmp/KorgSyncTraceTestXXXXXX";
+    const int   fd = ::mkstemp(path);
+    TEST_CHECK(fd >= 0);
+    ::close(fd);
+
+    //  concurrent writers, flushed while they write
+    {
+        KorgSyncTrace*  trace = KorgSyncTraceCreate(1000);
+        TEST_CHECK(trace != NULL);
+        KorgSyncTraceAppend(trace, 0, kKorgSyncTrace_Reset, 0, 0, 0, 0);     //  no file yet : ignored
+        TEST_CHECK(KorgSyncTraceOpen(trace, path) != 0);
+        Writer      writers[kWriters];
+        pthread_t   threads[kWriters];
+        for (int writerNo = 0; writerNo < kWriters; ++writerNo)
+        {
+            writers[writerNo].trace = trace;
+            writers[writerNo].writerNo = writerNo;
+            writers[writerNo].isDone = 0;
+            TEST_CHECK(::pthread_create(&threads[writerNo], NULL, Write, &writers[writerNo]) == 0);
+        }
+        for (int writerNo = 0; writerNo < kWriters; )
+        {
+            KorgSyncTraceFlush(trace);
+            ::sched_yield();
+            writerNo += (AtomicLoad32(&writers[writerNo].isDone) != 0) ? 1 : 0;
+        }
+        for (int writerNo = 0; writerNo < kWriters; ++writerNo)
+        {
+            ::pthread_join(threads[writerNo], NULL);
+        }
+        KorgSyncTraceDestroy(trace);   //  closes and flushes the rest
+
+        std::vector<KorgSyncTraceRecord>    records;
+        TEST_CHECK(ReadTrace(path, records));
+        std::vector<int>    next(kWriters, 0);
+        uint32_t    sequence = 0;
+        int64_t     dropped = 0;
+        int errors = 0;
+        for (size_t index = 0; index < records.size(); ++index)
+        {
+            const KorgSyncTraceRecord&  record = records[index];
+            if (record.type == kKorgSyncTrace_Dropped)
+            {
+                errors += (record.value[0] < dropped) ? 1 : 0;
+                dropped = record.value[0];
+                continue;
+            }
+            errors += (record.type != kKorgSyncTrace_Beacon) ? 1 : 0;
+            errors += (record.sequence != ++sequence) ? 1 : 0;
+            const int   writerNo = static_cast<int>(record.value[0]);
+            if ((writerNo < 0) || (writerNo >= kWriters))
+            {
+                ++errors;
+                continue;
+            }
+            //  a writer's records keep their order, the dropped ones leave gaps
+            errors += (record.value[1] < next[writerNo]) ? 1 : 0;
+            errors += ((static_cast<int64_t>(record.timeNano) != record.value[1]) || (record.value[3] != -1)) ? 1 : 0;
+            next[writerNo] = static_cast<int>(record.value[1]) + 1;
+        }
+        ::printf("%u records written, %lld dropped\n", sequence, static_cast<long long>(dropped));
+        TEST_CHECK(errors == 0);
+        TEST_CHECK(sequence + dropped == kWriters * kRecordsPerWriter);
+    }
+
+    //  a full ring : the overflow is counted and reported by the next flush
+    {
+        KorgSyncTrace*  trace = KorgSyncTraceCreate(5);     //  8 records
+        TEST_CHECK(KorgSyncTraceOpen(trace, path) != 0);
+        for (int recordNo = 0; recordNo < 11; ++recordNo)
+        {
+            KorgSyncTraceAppend(trace, recordNo, kKorgSyncTrace_Delay, recordNo, 0, 0, 0);
+        }
+        KorgSyncTraceFlush(trace);
+        KorgSyncTraceAppend(trace, 11, kKorgSyncTrace_Delay, 11, 0, 0, 0);
+        KorgSyncTraceClose(trace);
+        KorgSyncTraceAppend(trace, 12, kKorgSyncTrace_Delay, 12, 0, 0, 0);   //  closed : ignored
+        KorgSyncTraceDestroy(trace);
+
+        std::vector<KorgSyncTraceRecord>    records;
+        TEST_CHECK(ReadTrace(path, records));
+        TEST_CHECK(records.size() == 10);
+        if (records.size() == 10)
+        {
+            for (int index = 0; index < 8; ++index)
+            {
+                TEST_CHECK(records[index].value[0] == index);
+            }
+            TEST_CHECK((records[8].type == kKorgSyncTrace_Dropped) && (records[8].value[0] == 3));
+            TEST_CHECK((records[9].type == kKorgSyncTrace_Delay) && (records[9].value[0] == 11));
+        }
+    }
+
+    ::unlink(path);
+    return TestResult("KorgSyncTraceTest");
+}
@@ -0,0 +1,187 @@
+//
+//  LookAheadRendererTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  A ramp rendered ahead : the blocks read are the ramp, an invalidation re-renders from the
+//  checkpoint of its block on, missed blocks play as silence and are still rendered, and
+//  Stop() leaves the source at the first unread block.
+//
+
+#include <unistd.h>
+#include <vector>
+#include "LookAheadRenderer.h"
+#include "AtomicOps.h"
+#include "TestCheck.h"
+
+static const int    kBlockLength = 64;
+static const int    kBlocks = 8;
+static const int    kStems = 2;
+
+//
+//  stem n of frame p is (n + 1) * p * gain, the state is the next position
+//
+class RampSource : public LookAheadSource
+{
+public:
+    RampSource(void) :
+    gain_(1),
+    slow_(false),
+    position_(0),
+    rewinds_(0),
+    mismatches_(0)
+    {
+    }
+
+    void    SaveCheckpoint(int slotNo)      { checkpoints_[slotNo] = AtomicLoad64(&position_); }
+    void    RestoreCheckpoint(int slotNo)
+    {
+        AtomicStore64(&position_, checkpoints_[slotNo]);
+        ++rewinds_;
+    }
+    void    RenderAhead(float* const* stems, uint64_t position, int length)
+    {
+        if (slow_)
+        {
+            ::usleep(2000);
+        }
+        mismatches_ += (static_cast<int64_t>(position) != AtomicLoad64(&position_)) ? 1 : 0;
+        const int32_t   gain = AtomicLoad32(&gain_);
+        for (int stemNo = 0; stemNo < kStems; ++stemNo)
+        {
+            for (int frame = 0; frame < length; ++frame)
+            {
+                stems[stemNo][frame] = static_cast<float>((stemNo + 1) * (position + frame) * gain);
+            }
+        }
+        AtomicStore64(&position_, static_cast<int64_t>(position + length));
+    }
+
+    volatile int32_t    gain_;
+    volatile bool       slow_;
+    volatile int64_t    position_;
+    int64_t     checkpoints_[kBlocks];
+    volatile int32_t    rewinds_;
+    int         mismatches_;    //  worker
+};
+
+//  ---------------------------------------------------------------------------
+//      WaitForPosition
+//  ---------------------------------------------------------------------------
+//  until the worker has rewound rewinds times and rendered up to position, false after ~2 sec
+static bool
+WaitForPosition(RampSource& source, int64_t position, int32_t rewinds)
+{
+    for (int count = 0; count < 2000; ++count)
+    {
+        if ((AtomicLoad32(&source.rewinds_) == rewinds) && (AtomicLoad64(&source.position_) == position))
+        {
+            ::usleep(1000);     //  the counters are updated after RenderAhead()
+            return true;
+        }
+        ::usleep(1000);
+    }
+    return false;
+}
+
+//  ---------------------------------------------------------------------------
+//      ReadAndCheck
+//  ---------------------------------------------------------------------------
+//  frames, in reads of 40 frames; the positions from gainFrom on have newGain
+static int
+ReadAndCheck(LookAheadRenderer& renderer, int frames, int gain, uint64_t gainFrom, int newGain)
+{
+    std::vector<float>  stem0(40);
+    std::vector<float>  stem1(40);
+    float*  dest[] = { &stem0[0], &stem1[0] };
+    int errors = 0;
+    while (frames > 0)
+    {
+        const int   length = (frames < 40) ? frames : 40;
+        const uint64_t  position = renderer.GetReadPosition();
+        renderer.Read(dest, length);
+        for (int frame = 0; frame < length; ++frame)
+        {
+            const uint64_t  framePosition = position + frame;
+            const int   frameGain = (framePosition >= gainFrom) ? newGain : gain;
+            errors += (stem0[frame] != static_cast<float>(framePosition * frameGain)) ? 1 : 0;
+            errors += (stem1[frame] != static_cast<float>(2 * framePosition * frameGain)) ? 1 : 0;
+        }
+        frames -= length;
+    }
+    return errors;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    //  rewind : the blocks from the invalidated one on are rendered again
+    {
+        RampSource  source;
+        LookAheadRenderer   renderer(&source, kStems, kBlockLength, kBlocks);
+        TEST_CHECK(renderer.Start());
+        TEST_CHECK(WaitForPosition(source, (kBlocks - 1) * kBlockLength, 0));
+        TEST_CHECK(ReadAndCheck(renderer, 3 * kBlockLength, 1, ~0ULL, 1) == 0);
+        TEST_CHECK(WaitForPosition(source, (3 + kBlocks - 1) * kBlockLength, 0));
+
+        AtomicStore32(&source.gain_, 2);
+        renderer.Invalidate(5 * kBlockLength + 10);
+        TEST_CHECK(WaitForPosition(source, (3 + kBlocks - 1) * kBlockLength, 1));
+        TEST_CHECK(ReadAndCheck(renderer, 7 * kBlockLength, 1, 5 * kBlockLength, 2) == 0);
+
+        //  block 10 is being read and block 11 may be claimed any moment : rewound to block 12
+        TEST_CHECK(WaitForPosition(source, (10 + kBlocks - 1) * kBlockLength, 1));
+        TEST_CHECK(ReadAndCheck(renderer, kBlockLength / 2, 2, ~0ULL, 2) == 0);
+        TEST_CHECK(WaitForPosition(source, (11 + kBlocks - 1) * kBlockLength, 1));
+        AtomicStore32(&source.gain_, 3);
+        renderer.Invalidate(0);
+        TEST_CHECK(WaitForPosition(source, (11 + kBlocks - 1) * kBlockLength, 2));
+        TEST_CHECK(ReadAndCheck(renderer, 5 * kBlockLength / 2, 2, 12 * kBlockLength, 3) == 0);
+
+        //  Stop() restores the first unread block
+        TEST_CHECK(WaitForPosition(source, (13 + kBlocks - 1) * kBlockLength, 2));
+        renderer.Stop();
+        TEST_CHECK(AtomicLoad64(&source.position_) == static_cast<int64_t>(renderer.GetReadPosition()));
+        TEST_CHECK(source.rewinds_ == 3);
+        TEST_CHECK(source.mismatches_ == 0);
+        TEST_CHECK(renderer.GetUnderrunCount() == 0);
+    }
+
+    //  a slow source : the missed blocks are silent, then rendered all the same
+    {
+        RampSource  source;
+        source.slow_ = true;
+        LookAheadRenderer   renderer(&source, kStems, kBlockLength, kBlocks);
+        TEST_CHECK(renderer.Start());
+        std::vector<float>  stem0(kBlockLength);
+        std::vector<float>  stem1(kBlockLength);
+        float*  dest[] = { &stem0[0], &stem1[0] };
+        int nonSilent = 0;
+        for (int blockNo = 0; blockNo < 4; ++blockNo)
+        {
+            const uint32_t  underruns = renderer.GetUnderrunCount();
+            renderer.Read(dest, kBlockLength);
+            if (renderer.GetUnderrunCount() != underruns)
+            {
+                for (int frame = 0; frame < kBlockLength; ++frame)
+                {
+                    nonSilent += ((stem0[frame] != 0.0f) || (stem1[frame] != 0.0f)) ? 1 : 0;
+                }
+            }
+        }
+        TEST_CHECK(renderer.GetUnderrunCount() > 0);
+        TEST_CHECK(nonSilent == 0);
+        source.slow_ = false;
+        TEST_CHECK(WaitForPosition(source, (4 + kBlocks - 1) * kBlockLength, 0));
+        TEST_CHECK(ReadAndCheck(renderer, 4 * kBlockLength, 1, ~0ULL, 1) == 0);
+        renderer.Stop();
+        TEST_CHECK(source.mismatches_ == 0);
+    }
+
+    return TestResult("LookAheadRendererTest");
+}
@@ -0,0 +1,107 @@
+//
+//  SampleFormatTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Round trips of the PCM storage formats : packed int24 in host and swapped byte order,
+//  int16 and float32 scaling, and a DrumSampleData voice rendered at the original pitch.
+//
+
+#include <vector>
+#include "DrumSample.h"
+#include "TestCheck.h"
+
+//  ---------------------------------------------------------------------------
+//      PackInt24
+//  ---------------------------------------------------------------------------
+static void
+PackInt24(int32_t value, uint8_t* dest, bool swapped)
+{
+    const uint8_t   low = static_cast<uint8_t>(value);
+    const uint8_t   mid = static_cast<uint8_t>(value >> 8);
+    const uint8_t   high = static_cast<uint8_t>(value >> 16);
+#if defined(__BIG_ENDIAN__)
+    const bool  lowFirst = swapped;
+#else
+    const bool  lowFirst = !swapped;
+#endif
+    dest[0] = lowFirst ? low : high;
+    dest[1] = mid;
+    dest[2] = lowFirst ? high : low;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    static const int32_t    kValues[] = { 0, 1, -1, 0x123456, -0x123456, 0x7FFFFF, -0x800000, 0x00FF00, -0x0100 };
+    static const int        kNumberOfValues = sizeof(kValues) / sizeof(kValues[0]);
+
+    //  int24 : every value survives host order, and swapped order after SwapByteOrder()
+    for (int index = 0; index < kNumberOfValues; ++index)
+    {
+        uint8_t host[3];
+        PackInt24(kValues[index], host, false);
+        TEST_CHECK(SampleFormatInt24::Read(host) == kValues[index]);
+
+        uint8_t swapped[3];
+        PackInt24(kValues[index], swapped, true);
+        SampleFormatInt24::SwapByteOrder(swapped);
+        TEST_CHECK(SampleFormatInt24::Read(swapped) == kValues[index]);
+    }
+
+    //  int16 and float32 scale to the 24-bit range
+    int16_t int16Sample = -0x1234;
+    TEST_CHECK(SampleFormatInt16::Read(&int16Sample) == -0x1234 * 256);
+    SampleFormatInt16::SwapByteOrder(&int16Sample);
+    SampleFormatInt16::SwapByteOrder(&int16Sample);
+    TEST_CHECK(int16Sample == -0x1234);
+    float   floatSample = 0.5f;
+    TEST_CHECK(SampleFormatFloat32::Read(&floatSample) == 0x7FFFFF / 2);
+    floatSample = -2.0f;
+    TEST_CHECK(SampleFormatFloat32::Read(&floatSample) == -0x7FFFFF);
+
+    //  stereo int24 sample : ReadFrames() returns what was appended
+    const uint32_t  kFrames = 100;
+    std::vector<uint8_t>    packed(kFrames * 2 * 3);
+    std::vector<int32_t>    expected(kFrames * 2);
+    for (uint32_t index = 0; index < kFrames * 2; ++index)
+    {
+        expected[index] = static_cast<int32_t>(index * 83911) % 0x7FFFFF - 0x400000;
+        PackInt24(expected[index], &packed[index * 3], false);
+    }
+    DrumSampleData<SampleFormatInt24, 2>    sample;
+    sample.Append(&packed[0], kFrames / 2);
+    sample.Append(&packed[kFrames / 2 * 2 * 3], kFrames - kFrames / 2);
+    TEST_CHECK(sample.GetNumberOfFrames() == kFrames);
+    TEST_CHECK(sample.GetDataSize() == kFrames * 2 * 3);
+    std::vector<int32_t>    frames(kFrames * 2);
+    sample.ReadFrames(&frames[0], 0, kFrames);
+    TEST_CHECK(frames == expected);
+
+    //  rendered at the original pitch and unity amp, a voice outputs the samples scaled to +-1.0
+    DrumVoiceState  voice;
+    voice.currentAddress = 0;
+    voice.pitchOffset = 0x1000;
+    voice.ampCoef = 32768;
+    voice.panCoef = 0;
+    voice.isRunning = true;
+    voice.decodeCache = NULL;
+    const int   kLength = kFrames + 8;
+    std::vector<float>  output(kLength * 2, 9.0f);
+    sample.Render(voice, &output[0], 2, kLength);
+    int errors = 0;
+    for (uint32_t index = 0; index < kFrames * 2; ++index)
+    {
+        errors += (output[index] != static_cast<float>(expected[index]) / 8388608.0f) ? 1 : 0;
+    }
+    TEST_CHECK(errors == 0);
+    TEST_CHECK(output[kFrames * 2] == 9.0f);    //  frames after the end are left untouched
+    TEST_CHECK(!voice.isRunning);
+
+    return TestResult("SampleFormatTest");
+}
@@ -0,0 +1,110 @@
+//
+//  SeqlockTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  A reader never sees a torn value : every copy it gets is one the writer wrote, whole,
+//  and the copies it gets in turn are never older than the one before.
+//
+
+#include <pthread.h>
+#include <sched.h>
+#include "Seqlock.h"
+#include "TestCheck.h"
+
+static const int32_t    kWrites = 200000;
+
+//  every word holds the number of the write
+typedef struct {
+    int32_t     writeNo;
+    int32_t     words[63];
+} Value;
+
+typedef struct {
+    Seqlock<Value>      published;
+    volatile int32_t    isDone;
+} Shared;
+
+//  ---------------------------------------------------------------------------
+//      Write
+//  ---------------------------------------------------------------------------
+static void*
+Write(void* arg)
+{
+    Shared* shared = reinterpret_cast<Shared*>(arg);
+    Value   value;
+    for (int32_t writeNo = 1; writeNo <= kWrites; ++writeNo)
+    {
+        value.writeNo = writeNo;
+        for (int index = 0; index < 63; ++index)
+        {
+            value.words[index] = writeNo;
+        }
+        shared->published.Write(value);
+        if ((writeNo % 64) == 0)
+        {
+            ::sched_yield();
+        }
+    }
+    AtomicStore32(&shared->isDone, 1);
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    //  single thread : the last write is read back
+    {
+        Seqlock<Value>  published;
+        Value   value;
+        published.Read(value);
+        TEST_CHECK(value.writeNo == 0);
+        value.writeNo = 7;
+        published.Write(value);
+        value.writeNo = 0;
+        published.Read(value);
+        TEST_CHECK(value.writeNo == 7);
+    }
+
+    //  a reader against a writer that never waits
+    {
+        Shared  shared;
+        shared.isDone = 0;
+        pthread_t   writer;
+        TEST_CHECK(::pthread_create(&writer, NULL, Write, &shared) == 0);
+        int32_t lastWriteNo = 0;
+        int reads = 0;
+        int torn = 0;
+        int older = 0;
+        while (true)
+        {
+            const bool  isDone = (AtomicLoad32(&shared.isDone) != 0);
+            Value   value;
+            shared.published.Read(value);
+            ++reads;
+            for (int index = 0; index < 63; ++index)
+            {
+                torn += (value.words[index] != value.writeNo) ? 1 : 0;
+            }
+            older += (value.writeNo < lastWriteNo) ? 1 : 0;
+            lastWriteNo = value.writeNo;
+            if (isDone)
+            {
+                break;
+            }
+            ::sched_yield();
+        }
+        ::pthread_join(writer, NULL);
+        ::printf("%d reads\n", reads);
+        TEST_CHECK(torn == 0);
+        TEST_CHECK(older == 0);
+        TEST_CHECK(lastWriteNo == kWrites);     //  read after the writer was done
+    }
+
+    return TestResult("SeqlockTest");
+}
@@ -0,0 +1,175 @@
+//
+//  SequencerTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  A saved state keeps its pattern snapshot : restored after a bar switch it renders the notes
+//  of the first pass again, and the snapshot is only freed once the state is discarded.
+//
+
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include "Sequencer.h"
+#include "TestCheck.h"
+
+static const float  kSamplingRate = 44100.0f;
+static const int    kBlockLength = 64;
+static const float  kStepFrames = kSamplingRate * 60.0f / 120.0f / 4;
+
+//  the pattern snapshot watched for its deletion
+static const void*  gWatched = NULL;
+static bool         gWatchedFreed = false;
+
+//  ---------------------------------------------------------------------------
+//      operator new
+//  ---------------------------------------------------------------------------
+void*
+operator new(size_t size) throw(std::bad_alloc)
+{
+    void*   ptr = ::malloc((size != 0) ? size : 1);
+    if (ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+//  ---------------------------------------------------------------------------
+//      operator delete
+//  ---------------------------------------------------------------------------
+void
+operator delete(void* ptr) throw()
+{
+    if ((ptr != NULL) && (ptr == gWatched))
+    {
+        gWatchedFreed = true;
+    }
+    ::free(ptr);
+}
+
+//
+//  note-ons by sequencer position
+//
+class NoteRecorder : public SequencerListener
+{
+public:
+    typedef struct {
+        uint64_t    position;
+        int         trackNo;
+    } Note;
+
+    NoteRecorder(void) : base_(0), notes_() {}
+
+    void    NoteOnViaSequencer(int frame, int partNo)
+    {
+        const Note  note = { base_ + frame, partNo };
+        notes_.push_back(note);
+    }
+
+    uint64_t            base_;      //  position of frame 0 of the block being processed
+    std::vector<Note>   notes_;
+};
+
+//  ---------------------------------------------------------------------------
+//      ProcessTo
+//  ---------------------------------------------------------------------------
+static void
+ProcessTo(Sequencer& seq, NoteRecorder& recorder, uint64_t position)
+{
+    while (seq.GetPosition() < position)
+    {
+        recorder.base_ = seq.GetPosition();
+        seq.Process(static_cast<uint64_t>(0), 0, 0, kBlockLength);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      CountNotes
+//  ---------------------------------------------------------------------------
+//  notes of trackNo in [from, to)
+static int
+CountNotes(const std::vector<NoteRecorder::Note>& notes, int trackNo, uint64_t from, uint64_t to)
+{
+    int result = 0;
+    for (size_t index = 0; index < notes.size(); ++index)
+    {
+        if ((notes[index].trackNo == trackNo) && (notes[index].position >= from) && (notes[index].position < to))
+        {
+            ++result;
+        }
+    }
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    Sequencer   seq(kSamplingRate);
+    NoteRecorder    recorder;
+    seq.SetListener(&recorder);
+    seq.SetCommandLogEnabled(true);
+    seq.SetPatternSwitch(Sequencer::kPatternSwitch_Bar);
+    Sequencer::Pattern  pattern(seq.GetNumberOfTracks(), std::vector<bool>(seq.GetNumberOfSteps(), false));
+    pattern[1][0] = true;
+    seq.SetPattern(pattern);
+    seq.Start(0, 120.0f);
+
+    //  save mid-bar, then edit : the edit waits for the next bar
+    const uint64_t  barFrames = static_cast<uint64_t>(kStepFrames * seq.GetNumberOfSteps());
+    ProcessTo(seq, recorder, static_cast<uint64_t>(kStepFrames * 2.5f));
+    Sequencer::State    state;
+    seq.SaveState(state);
+    const size_t    savedNotes = recorder.notes_.size();
+    gWatched = state.pattern;
+    TEST_CHECK(state.pattern != NULL);
+    seq.Set(0, 4, true);
+    ProcessTo(seq, recorder, barFrames + static_cast<uint64_t>(kStepFrames * 8));
+    const uint64_t  end = seq.GetPosition();
+    TEST_CHECK(CountNotes(recorder.notes_, 0, 0, barFrames) == 0);
+    TEST_CHECK(CountNotes(recorder.notes_, 0, barFrames, end) == 1);
+    TEST_CHECK(CountNotes(recorder.notes_, 1, 0, end) == 2);
+    seq.CollectPatterns();
+    TEST_CHECK(!gWatchedFreed);     //  switched away from at the bar, still saved
+
+    //  rewound to the saved state : the same notes, the edit still waits for the bar
+    std::vector<NoteRecorder::Note> firstPass(recorder.notes_.begin() + savedNotes, recorder.notes_.end());
+    recorder.notes_.resize(savedNotes);
+    seq.RestoreState(state);
+    TEST_CHECK(seq.GetPosition() == state.position);
+    seq.SaveState(state);           //  as the look-ahead worker does before rendering a block again
+    ProcessTo(seq, recorder, end);
+    std::vector<NoteRecorder::Note> secondPass(recorder.notes_.begin() + savedNotes, recorder.notes_.end());
+    TEST_CHECK(firstPass.size() == secondPass.size());
+    for (size_t index = 0; (index < firstPass.size()) && (index < secondPass.size()); ++index)
+    {
+        TEST_CHECK(firstPass[index].position == secondPass[index].position);
+        TEST_CHECK(firstPass[index].trackNo == secondPass[index].trackNo);
+    }
+    seq.CollectPatterns();
+    TEST_CHECK(!gWatchedFreed);
+
+    //  once the state is discarded the snapshot goes
+    seq.DiscardCommandLog(seq.GetPosition());
+    seq.CollectPatterns();
+    TEST_CHECK(gWatchedFreed);
+    gWatched = NULL;
+
+    //  without the log a saved state does not hold its snapshot
+    seq.SetCommandLogEnabled(false);
+    seq.SaveState(state);
+    gWatched = state.pattern;
+    gWatchedFreed = false;
+    seq.Set(0, 5, true);
+    ProcessTo(seq, recorder, seq.GetPosition() + barFrames);
+    seq.CollectPatterns();
+    TEST_CHECK(gWatchedFreed);
+    gWatched = NULL;
+
+    return TestResult("SequencerTest");
+}
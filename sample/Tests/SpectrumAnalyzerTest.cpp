@@ -0,0 +1,122 @@
+//
+//  SpectrumAnalyzerTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  A full scale sine reads 0 dB in its bin, up to Nyquist, with nothing folded back below
+//  it. A restart begins from silence : what was tapped before Stop() does not show.
+//
+
+#include <math.h>
+#include <unistd.h>
+#include <vector>
+#include "SpectrumAnalyzer.h"
+#include "TestCheck.h"
+
+static const float  kSamplingRate = 44100.0f;
+static const int    kBufferLength = 256;
+
+//  ---------------------------------------------------------------------------
+//      TapSine
+//  ---------------------------------------------------------------------------
+//  length frames of a full scale sine centered on binNo, both channels, as the audio thread would
+static void
+TapSine(SpectrumAnalyzer& analyzer, int binNo, int length)
+{
+    std::vector<float>  buffer(kBufferLength);
+    for (int offset = 0; offset < length; offset += kBufferLength)
+    {
+        const int   frames = (length - offset < kBufferLength) ? length - offset : kBufferLength;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const double    phase = 2.0 * M_PI * binNo * (offset + frame) / SpectrumAnalyzer::kFFTLength;
+            buffer[frame] = static_cast<float>(::sin(phase));
+        }
+        analyzer.Tap(&buffer[0], &buffer[0], frames);
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      WaitForBin
+//  ---------------------------------------------------------------------------
+//  until binNo reads above minDB, false after ~2 sec
+static bool
+WaitForBin(SpectrumAnalyzer& analyzer, int binNo, float minDB, SpectrumAnalyzer::Spectrum& spectrum)
+{
+    for (int count = 0; count < 200; ++count)
+    {
+        analyzer.Read(spectrum);
+        if (spectrum.magnitude[binNo] > minDB)
+        {
+            return true;
+        }
+        ::usleep(10000);
+    }
+    return false;
+}
+
+//  ---------------------------------------------------------------------------
+//      MaxBelow
+//  ---------------------------------------------------------------------------
+//  loudest bin under toBin
+static float
+MaxBelow(const SpectrumAnalyzer::Spectrum& spectrum, int toBin)
+{
+    float   result = -200.0f;
+    for (int binNo = 1; binNo < toBin; ++binNo)
+    {
+        result = (spectrum.magnitude[binNo] > result) ? spectrum.magnitude[binNo] : result;
+    }
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    SpectrumAnalyzer    analyzer(kSamplingRate);
+    TEST_CHECK(::fabsf(analyzer.GetBinWidth() - kSamplingRate / SpectrumAnalyzer::kFFTLength) < 1.0e-3f);
+    SpectrumAnalyzer::Spectrum  spectrum;
+
+    //  ignored while stopped
+    TapSine(analyzer, 93, SpectrumAnalyzer::kFFTLength);
+    analyzer.Read(spectrum);
+    TEST_CHECK(spectrum.magnitude[93] <= -119.0f);
+
+    //  ~15kHz : its own level in its bin, no alias under 10kHz
+    const int   highBin = 697;
+    const int   bandBin = static_cast<int>(10000.0f / analyzer.GetBinWidth());
+    TEST_CHECK(analyzer.Start());
+    TEST_CHECK(analyzer.IsRunning());
+    TapSine(analyzer, highBin, 2 * SpectrumAnalyzer::kFFTLength);
+    TEST_CHECK(WaitForBin(analyzer, highBin, -1.0f, spectrum));
+    ::printf("%.0f Hz : %.2f dB, loudest under 10kHz %.1f dB\n", highBin * analyzer.GetBinWidth(),
+             spectrum.magnitude[highBin], MaxBelow(spectrum, bandBin));
+    TEST_CHECK(::fabsf(spectrum.magnitude[highBin]) < 0.5f);
+    TEST_CHECK(MaxBelow(spectrum, bandBin) < -90.0f);
+
+    //  stopped with ~1kHz queued and a block half tapped, restarted : the first spectrum is
+    //  silence, then only the new ~5kHz half a window long shows
+    const int   oldBin = 46;
+    const int   newBin = 232;
+    TapSine(analyzer, oldBin, 4 * SpectrumAnalyzer::kTapBlockLength + 40);
+    analyzer.Stop();
+    TEST_CHECK(!analyzer.IsRunning());
+    TEST_CHECK(analyzer.Start());
+    analyzer.Read(spectrum);
+    TEST_CHECK(spectrum.magnitude[highBin] <= -119.0f);
+    TapSine(analyzer, newBin, SpectrumAnalyzer::kFFTLength / 2);
+    TEST_CHECK(WaitForBin(analyzer, newBin, -12.0f, spectrum));
+    ::usleep(100000);   //  every block analyzed
+    analyzer.Read(spectrum);
+    ::printf("restarted : %.1f dB at %.0f Hz, %.1f dB at %.0f Hz\n", spectrum.magnitude[newBin], newBin * analyzer.GetBinWidth(),
+             spectrum.magnitude[oldBin], oldBin * analyzer.GetBinWidth());
+    TEST_CHECK(spectrum.magnitude[oldBin] < -40.0f);     //  the leakage of the new onset is ~-50dB
+    analyzer.Stop();
+
+    return TestResult("SpectrumAnalyzerTest");
+}
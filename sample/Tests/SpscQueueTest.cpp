@@ -0,0 +1,91 @@
+//
+//  SpscQueueTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  The queue holds its capacity rounded up to a power of two, refuses more, and passes
+//  every item in order from a producer thread to a consumer thread across many wraps.
+//
+
+#include <pthread.h>
+#include <sched.h>
+#include "SpscQueue.h"
+#include "TestCheck.h"
+
+static const int32_t    kItems = 200000;
+
+//  ---------------------------------------------------------------------------
+//      Produce
+//  ---------------------------------------------------------------------------
+static void*
+Produce(void* arg)
+{
+    SpscQueue<int32_t>* queue = reinterpret_cast<SpscQueue<int32_t>*>(arg);
+    for (int32_t item = 0; item < kItems; )
+    {
+        if (queue->Push(item))
+        {
+            ++item;
+        }
+        else
+        {
+            ::sched_yield();
+        }
+    }
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    //  single thread : capacity, FIFO order, empty
+    {
+        SpscQueue<int32_t>  queue(5);
+        int pushed = 0;
+        while (queue.Push(pushed) && (pushed < 100))
+        {
+            ++pushed;
+        }
+        TEST_CHECK(pushed == 8);
+        int32_t item = -1;
+        for (int index = 0; index < pushed; ++index)
+        {
+            TEST_CHECK(queue.Pop(item) && (item == index));
+        }
+        TEST_CHECK(!queue.Pop(item));
+        TEST_CHECK(queue.Push(42) && queue.Pop(item) && (item == 42));
+    }
+
+    //  two threads through a small queue : nothing lost, duplicated or reordered
+    {
+        SpscQueue<int32_t>  queue(64);
+        pthread_t   producer;
+        TEST_CHECK(::pthread_create(&producer, NULL, Produce, &queue) == 0);
+        int32_t expected = 0;
+        int errors = 0;
+        while (expected < kItems)
+        {
+            int32_t item;
+            if (queue.Pop(item))
+            {
+                errors += (item != expected) ? 1 : 0;
+                expected = item + 1;
+            }
+            else
+            {
+                ::sched_yield();
+            }
+        }
+        ::pthread_join(producer, NULL);
+        int32_t item;
+        TEST_CHECK(errors == 0);
+        TEST_CHECK(!queue.Pop(item));
+    }
+
+    return TestResult("SpscQueueTest");
+}
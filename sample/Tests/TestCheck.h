@@ -0,0 +1,35 @@
+//
+//  TestCheck.h
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Checks of the host tests : a failed check is printed and counted, main returns
+//  TestResult() so that make stops at the first failing test.
+//
+
+#pragma once
+
+#include <stdio.h>
+
+static int  gTestFailures = 0;
+
+#define TEST_CHECK(condition)                                                           \
+    do {                                                                                \
+        if (!(condition))                                                               \
+        {                                                                               \
+            ::printf("%s:%d: check failed : %s\n", __FILE__, __LINE__, #condition);     \
+            ++gTestFailures;                                                            \
+        }                                                                               \
+    } while (0)
+
+//  ---------------------------------------------------------------------------
+//      TestResult
+//  ---------------------------------------------------------------------------
+static inline int
+TestResult(const char* name)
+{
+    ::printf("%s : %s\n", name, (gTestFailures == 0) ? "passed" : "FAILED");
+    return (gTestFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+//
+//  VoiceFilterBankTest.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  A retrigger restarts the envelope without a step in the filter output, a silent lane
+//  settles to exact silence once reset, and a saved state renders the same frames again.
+//
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "VoiceFilterBank.h"
+#include "TestCheck.h"
+
+static const float  kSamplingRate = 44100.0f;
+static const int    kLanes = VoiceFilterBank::kMaxLanes;
+
+//  ---------------------------------------------------------------------------
+//      FillSine
+//  ---------------------------------------------------------------------------
+//  a sine on lane 0 and a slower one on lane 5, the other lanes silent
+static void
+FillSine(std::vector<float>& buffer, int firstFrame, int length)
+{
+    buffer.assign(length * kLanes, 0.0f);
+    for (int frame = 0; frame < length; ++frame)
+    {
+        const float t = (firstFrame + frame) / kSamplingRate;
+        buffer[frame * kLanes] = ::sinf(2.0f * static_cast<float>(M_PI) * 440.0f * t) * 0.8f;
+        buffer[frame * kLanes + 5] = ::sinf(2.0f * static_cast<float>(M_PI) * 110.0f * t) * 0.5f;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//      MaxStep
+//  ---------------------------------------------------------------------------
+static float
+MaxStep(const std::vector<float>& buffer, int lane, int from, int to)
+{
+    float   result = 0.0f;
+    for (int frame = from + 1; frame < to; ++frame)
+    {
+        result = std::max(result, ::fabsf(buffer[frame * kLanes + lane] - buffer[(frame - 1) * kLanes + lane]));
+    }
+    return result;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(void)
+{
+    //  retrigger while ringing : the output continues, no step beyond the signal's own slope
+    {
+        VoiceFilterBank bank(kSamplingRate);
+        bank.SetCutoff(0, 2000.0f);
+        bank.SetResonance(0, 4.0f);
+        const int   kLength = 4096;
+        const int   kTriggerFrame = 2000;
+        std::vector<float>  buffer;
+        FillSine(buffer, 0, kLength);
+        std::vector<float>  first(buffer.begin(), buffer.begin() + kTriggerFrame * kLanes);
+        std::vector<float>  second(buffer.begin() + kTriggerFrame * kLanes, buffer.end());
+        bank.Process(&first[0], kLanes, kTriggerFrame);
+        bank.Trigger(0);
+        bank.Process(&second[0], kLanes, kLength - kTriggerFrame);
+        first.insert(first.end(), second.begin(), second.end());
+
+        const float steadyStep = MaxStep(first, 0, kTriggerFrame - 1000, kTriggerFrame);
+        const float triggerStep = MaxStep(first, 0, kTriggerFrame - 1, kTriggerFrame + 1);
+        ::printf("step at retrigger : %f, steady : %f\n", triggerStep, steadyStep);
+        TEST_CHECK(steadyStep > 0.0f);
+        TEST_CHECK(triggerStep <= steadyStep * 1.01f);
+    }
+
+    //  the envelope restarts at the trigger
+    {
+        VoiceFilterBank bank(kSamplingRate);
+        bank.SetDecay(0, 0.05f);
+        std::vector<float>  buffer(kLanes * 4096, 0.0f);
+        for (int frame = 0; frame < 4096; ++frame)
+        {
+            buffer[frame * kLanes] = 1.0f;
+        }
+        std::vector<float>  again(buffer);
+        bank.Process(&buffer[0], kLanes, 4096);
+        bank.Trigger(0);
+        bank.Process(&again[0], kLanes, 1);
+        TEST_CHECK(buffer[4095 * kLanes] < 0.01f);
+        TEST_CHECK(again[0] > 0.9f);
+    }
+
+    //  silent input : the lane stops ringing, then outputs exact zeros once reset
+    {
+        VoiceFilterBank bank(kSamplingRate);
+        bank.SetResonance(0, 10.0f);
+        std::vector<float>  buffer;
+        FillSine(buffer, 0, 512);
+        bank.Process(&buffer[0], kLanes, 512);
+        TEST_CHECK(bank.IsRinging(0));
+        TEST_CHECK(bank.IsRinging(5));
+        TEST_CHECK(!bank.IsRinging(1));
+        int blocks = 0;
+        while (bank.IsRinging(0) && (blocks < 1000))
+        {
+            buffer.assign(512 * kLanes, 0.0f);
+            bank.Process(&buffer[0], kLanes, 512);
+            ++blocks;
+        }
+        TEST_CHECK(blocks < 1000);
+        bank.Reset(0);
+        bank.Reset(5);
+        buffer.assign(512 * kLanes, 0.0f);
+        bank.Process(&buffer[0], kLanes, 512);
+        int nonZero = 0;
+        for (size_t index = 0; index < buffer.size(); ++index)
+        {
+            nonZero += (buffer[index] != 0.0f) ? 1 : 0;
+        }
+        TEST_CHECK(nonZero == 0);
+    }
+
+    //  a restored state renders the same frames
+    {
+        VoiceFilterBank bank(kSamplingRate);
+        bank.SetCutoff(5, 800.0f);
+        bank.SetDecay(5, 0.3f);
+        std::vector<float>  buffer;
+        FillSine(buffer, 0, 300);
+        bank.Process(&buffer[0], kLanes, 300);
+        VoiceFilterBank::State  state;
+        bank.SaveState(state);
+        std::vector<float>  first;
+        FillSine(first, 300, 300);
+        std::vector<float>  second(first);
+        bank.Process(&first[0], kLanes, 300);
+        bank.RestoreState(state);
+        bank.Process(&second[0], kLanes, 300);
+        TEST_CHECK(first == second);
+    }
+
+    return TestResult("VoiceFilterBankTest");
+}
@@ -0,0 +1,282 @@
+//
+//  SyncTraceReplay.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Replays a trace written by -[KorgWirelessSyncStart startTrace:] (master side) through
+//  KorgSyncEstimator and reports, for every start command, the start alignment error the
+//  estimate predicts.
+//
+//  Both devices delay the start by the same lead and their own output latency, so the
+//  slave starts off by (timeDiff used - true clock offset). The true offset is not known;
+//  the reference is a least squares line through the offsets of the quarter of the beacons
+//  with the shortest round trips within +-window seconds of the start, evaluated at the
+//  start, so that it follows the clock drift and does not hinge on any single beacon.
+//  "minrtt" is what a causal estimator would have sent : the offset of the shortest round
+//  trip of the last 16 beacons before the start. Every offset sample, the reference
+//  included, carries the asymmetry of its one way delays, so the errors are relative to
+//  the fit : an asymmetry common to all beacons does not show. After each reset the time
+//  until the estimator reports a stable offset (the master's isSyncReady) is printed as well.
+//
+//      cc -O2 -c -I../../WIST ../../WIST/KorgSyncEstimator.c
+//      c++ -O2 -I../../WIST -o SyncTraceReplay SyncTraceReplay.cpp KorgSyncEstimator.o
+//      ./SyncTraceReplay wist.trace [window seconds, default 5]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "KorgSyncEstimator.h"
+#include "KorgSyncTrace.h"
+
+enum
+{
+    kCausalBeacons = 16,
+    kReferenceQuantile = 4,     //  the reference fits the best 1 / 4 round trips
+};
+
+typedef struct {
+    uint64_t    sentNano;
+    uint64_t    remoteReceivedNano;
+    uint64_t    remoteSentNano;
+    uint64_t    receivedNano;
+    uint64_t    rtt;            //  without the time spent in the peer
+    double      offset;         //  remote - local at the midpoint of the round trip
+} Beacon;
+
+//  ---------------------------------------------------------------------------
+//      ReadTrace
+//  ---------------------------------------------------------------------------
+static bool
+ReadTrace(const char* path, std::vector<KorgSyncTraceRecord>& records)
+{
+    FILE*   file = ::fopen(path, "rb");
+    if (file == NULL)
+    {
+        ::fprintf(stderr, "can not open %s\n", path);
+        return false;
+    }
+    KorgSyncTraceHeader header;
+    const bool  isValid = (::fread(&header, sizeof(header), 1, file) == 1) && (header.magic == kKorgSyncTraceMagic)
+                            && (header.version == kKorgSyncTraceVersion) && (header.recordSize == sizeof(KorgSyncTraceRecord));
+    if (!isValid)
+    {
+        ::fprintf(stderr, "%s is not a sync trace of this version\n", path);
+        ::fclose(file);
+        return false;
+    }
+    KorgSyncTraceRecord record;
+    while (::fread(&record, sizeof(record), 1, file) == 1)
+    {
+        records.push_back(record);
+    }
+    ::fclose(file);
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      ReferenceOffset
+//  ---------------------------------------------------------------------------
+//  fit of the best round trips received within window of timeNano, at timeNano; false if none
+static bool
+ReferenceOffset(const std::vector<Beacon>& beacons, uint64_t timeNano, uint64_t window, double& offset)
+{
+    std::vector<const Beacon*>  candidates;
+    for (size_t index = 0; index < beacons.size(); ++index)
+    {
+        const Beacon&   beacon = beacons[index];
+        const uint64_t  distance = (beacon.receivedNano > timeNano) ? beacon.receivedNano - timeNano : timeNano - beacon.receivedNano;
+        if (distance <= window)
+        {
+            candidates.push_back(&beacon);
+        }
+    }
+    if (candidates.empty())
+    {
+        return false;
+    }
+    std::vector<uint64_t>   rtts;
+    for (size_t index = 0; index < candidates.size(); ++index)
+    {
+        rtts.push_back(candidates[index]->rtt);
+    }
+    std::sort(rtts.begin(), rtts.end());
+    const uint64_t  threshold = rtts[rtts.size() / kReferenceQuantile];
+
+    //  offset = a + b * (t - timeNano), t in sec to keep the sums small
+    double  n = 0, sumT = 0, sumTT = 0, sumO = 0, sumTO = 0;
+    for (size_t index = 0; index < candidates.size(); ++index)
+    {
+        const Beacon&   beacon = *candidates[index];
+        if (beacon.rtt <= threshold)
+        {
+            const double    t = (static_cast<double>(beacon.receivedNano) - static_cast<double>(timeNano)) / 1e9;
+            n += 1;
+            sumT += t;
+            sumTT += t * t;
+            sumO += beacon.offset;
+            sumTO += t * beacon.offset;
+        }
+    }
+    const double    det = n * sumTT - sumT * sumT;
+    if ((n < 3) || (::fabs(det) < 1e-12))
+    {
+        offset = sumO / n;      //  too few to tell the drift
+        return true;
+    }
+    offset = (sumTT * sumO - sumT * sumTO) / det;
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        ::fprintf(stderr, "usage : %s trace [window seconds]\n", argv[0]);
+        return 1;
+    }
+    const uint64_t  window = static_cast<uint64_t>(((argc > 2) ? ::atof(argv[2]) : 5.0) * 1000000000.0);
+    std::vector<KorgSyncTraceRecord>    records;
+    if (!ReadTrace(argv[1], records))
+    {
+        return 1;
+    }
+
+    //  all beacons first, the reference may look ahead
+    std::vector<Beacon> beacons;
+    for (size_t index = 0; index < records.size(); ++index)
+    {
+        const KorgSyncTraceRecord&  record = records[index];
+        if (record.type == kKorgSyncTrace_Beacon)
+        {
+            Beacon  beacon;
+            beacon.sentNano = record.value[0];
+            beacon.remoteSentNano = record.value[1];
+            beacon.receivedNano = record.value[2];
+            beacon.remoteReceivedNano = record.value[3];
+            const uint64_t  remoteNano = beacon.remoteSentNano - beacon.remoteReceivedNano;
+            beacon.rtt = beacon.receivedNano - beacon.sentNano - remoteNano;
+            beacon.offset = ((static_cast<double>(beacon.remoteReceivedNano) - beacon.sentNano)
+                             + (static_cast<double>(beacon.remoteSentNano) - beacon.receivedNano)) / 2;
+            beacons.push_back(beacon);
+        }
+    }
+
+    KorgSyncEstimator   estimator;
+    KorgSyncEstimatorReset(&estimator);
+    std::vector<uint64_t>   rtts;
+    std::vector<double>     errors, causalErrors;
+    size_t  beaconNo = 0, numOfRejected = 0, numOfMismatches = 0;
+    uint32_t    droppedCount = 0;
+    uint64_t    resetNano = 0;
+    bool        isReady = true;
+    ::printf("   time s   timeDiff ms  recorded ms  reference ms   error ms  minrtt error ms   worst delay ms\n");
+    ::printf("   (errors relative to the fit of the best round trips, see the top of SyncTraceReplay.cpp)\n");
+    for (size_t index = 0; index < records.size(); ++index)
+    {
+        const KorgSyncTraceRecord&  record = records[index];
+        switch (record.type)
+        {
+            case kKorgSyncTrace_Reset:
+                KorgSyncEstimatorReset(&estimator);
+                resetNano = record.timeNano;
+                isReady = false;
+                break;
+            case kKorgSyncTrace_Beacon:
+                {
+                    const Beacon&   beacon = beacons[beaconNo];
+                    if (KorgSyncEstimatorAddBeacon(&estimator, beacon.sentNano, beacon.remoteReceivedNano, beacon.remoteSentNano, beacon.receivedNano))
+                    {
+                        rtts.push_back(beacon.rtt);
+                    }
+                    else
+                    {
+                        ++numOfRejected;
+                    }
+                    ++beaconNo;
+                }
+                if (!isReady && KorgSyncEstimatorIsStable(&estimator))
+                {
+                    ::printf("%9.3f   ready %.0f ms after the reset, jitter %.3f ms\n", record.timeNano / 1e9,
+                             (record.timeNano - resetNano) / 1e6, estimator.jitter / 1e6);
+                    isReady = true;
+                }
+                break;
+            case kKorgSyncTrace_Start:
+                {
+                    if (!estimator.beaconReceived)
+                    {
+                        ::printf("%9.3f   start without a beacon, the slave starts immediately\n", record.timeNano / 1e9);
+                        break;
+                    }
+                    //  the recorded estimate is truncated to integer nanosec
+                    if (::fabs(static_cast<double>(record.value[2]) - estimator.timeDiff) > 1.0)
+                    {
+                        ++numOfMismatches;
+                    }
+                    double  reference = 0;
+                    if (!ReferenceOffset(beacons, record.timeNano, window, reference))
+                    {
+                        ::printf("%9.3f   no beacon within the window\n", record.timeNano / 1e9);
+                        break;
+                    }
+                    const Beacon*   causal = NULL;
+                    for (size_t prev = beaconNo; (prev > 0) && (prev + kCausalBeacons > beaconNo); --prev)
+                    {
+                        if ((causal == NULL) || (beacons[prev - 1].rtt < causal->rtt))
+                        {
+                            causal = &beacons[prev - 1];
+                        }
+                    }
+                    const double    error = estimator.timeDiff - reference;
+                    const double    causalError = (causal != NULL) ? causal->offset - reference : 0;
+                    errors.push_back(error);
+                    causalErrors.push_back(causalError);
+                    ::printf("%9.3f  %12.3f %12.3f  %12.3f %10.3f  %15.3f  %15.3f\n", record.timeNano / 1e9,
+                             estimator.timeDiff / 1e6, record.value[2] / 1e6, reference / 1e6, error / 1e6, causalError / 1e6,
+                             estimator.worstDelay / 1e6);
+                }
+                break;
+            case kKorgSyncTrace_Dropped:
+                droppedCount = static_cast<uint32_t>(record.value[0]);
+                break;
+            default:
+                break;
+        }
+    }
+
+    ::printf("\n%zu records, %zu beacons (%zu rejected), %u records dropped while tracing\n",
+             records.size(), beacons.size(), numOfRejected, droppedCount);
+    if (!rtts.empty())
+    {
+        std::sort(rtts.begin(), rtts.end());
+        ::printf("round trip ms : min %.3f  median %.3f  p95 %.3f  max %.3f\n", rtts.front() / 1e6, rtts[rtts.size() / 2] / 1e6,
+                 rtts[rtts.size() * 95 / 100] / 1e6, rtts.back() / 1e6);
+    }
+    if (!errors.empty())
+    {
+        double  sum = 0, sumCausal = 0, worst = 0, worstCausal = 0;
+        for (size_t index = 0; index < errors.size(); ++index)
+        {
+            sum += errors[index] * errors[index];
+            sumCausal += causalErrors[index] * causalErrors[index];
+            worst = std::max(worst, ::fabs(errors[index]));
+            worstCausal = std::max(worstCausal, ::fabs(causalErrors[index]));
+        }
+        ::printf("start alignment error ms vs. the fit : estimator rms %.3f worst %.3f, minrtt rms %.3f worst %.3f\n",
+                 ::sqrt(sum / errors.size()) / 1e6, worst / 1e6, ::sqrt(sumCausal / errors.size()) / 1e6, worstCausal / 1e6);
+    }
+    if (numOfMismatches > 0)
+    {
+        ::printf("%zu starts recorded a different estimate than the replay (trace dropped records?)\n", numOfMismatches);
+    }
+    return 0;
+}
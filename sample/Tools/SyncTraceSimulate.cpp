@@ -0,0 +1,105 @@
+//
+//  SyncTraceSimulate.cpp
+//  WISTSample
+//
+//  Created by agent on 26/10/19.
+//  Copyright 2026 KORG INC. All rights reserved.
+//
+//  Writes a master side trace of a simulated connection for SyncTraceReplay : beacons paced
+//  by KorgSyncEstimatorBeaconInterval() as the sync thread does, over a link with random
+//  one way delays (uniform, master -> slave and slave -> master drawn independently) and a
+//  random time spent in the slave, against a fixed clock offset of 123456789 ns. A start
+//  is traced every 60 beacons with the estimate of that time, and a burst is requested
+//  after 200 beacons as a latency change would.
+//
+//      cc -O2 -c -I../../WIST ../../WIST/KorgSyncEstimator.c ../../WIST/KorgSyncTrace.c
+//      c++ -O2 -I../../WIST -o SyncTraceSimulate SyncTraceSimulate.cpp KorgSyncEstimator.o KorgSyncTrace.o -lpthread
+//      ./SyncTraceSimulate sim.trace [max up msec, default 23] [max down msec, default 8] [seed, default 2]
+//      ./SyncTraceReplay sim.trace
+//
+//  Every delay is at least 3 ms, the slave spends 0.5 to 2.5 ms; 60 seconds are simulated.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "KorgSyncEstimator.h"
+#include "KorgSyncTrace.h"
+
+enum
+{
+    kBeaconsPerStart = 60,
+    kBurstAtBeacon = 200,
+};
+
+static const double     kOffsetNano = 123456789.0;
+static const uint64_t   kMinDelayNano = 3000000ULL;
+static const uint64_t   kMinRemoteNano = 500000ULL;
+static const uint64_t   kMaxRemoteNano = 2500000ULL;
+static const uint64_t   kDurationNano = 60000000000ULL;
+
+//  ---------------------------------------------------------------------------
+//      Random
+//  ---------------------------------------------------------------------------
+//  uniform in [minNano, maxNano)
+static uint64_t
+Random(uint64_t minNano, uint64_t maxNano)
+{
+    return (maxNano > minNano) ? minNano + static_cast<uint64_t>(::rand()) % (maxNano - minNano) : minNano;
+}
+
+//  ---------------------------------------------------------------------------
+//      main
+//  ---------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        ::fprintf(stderr, "usage : %s trace [max up msec] [max down msec] [seed]\n", argv[0]);
+        return 1;
+    }
+    const uint64_t  maxUpNano = static_cast<uint64_t>(((argc > 2) ? ::atof(argv[2]) : 23.0) * 1.0e6);
+    const uint64_t  maxDownNano = static_cast<uint64_t>(((argc > 3) ? ::atof(argv[3]) : 8.0) * 1.0e6);
+    ::srand((argc > 4) ? ::atoi(argv[4]) : 2);
+
+    KorgSyncTrace*  trace = KorgSyncTraceCreate(16);
+    if ((trace == NULL) || (KorgSyncTraceOpen(trace, argv[1]) == 0))
+    {
+        ::fprintf(stderr, "can not open %s\n", argv[1]);
+        return 1;
+    }
+    KorgSyncEstimator   estimator;
+    KorgSyncEstimatorReset(&estimator);
+
+    uint64_t    nowNano = 1000000000ULL;
+    KorgSyncTraceAppend(trace, nowNano, kKorgSyncTrace_Reset, 0, 0, 0, 0);
+    int numberOfBeacons = 0;
+    while (nowNano < kDurationNano)
+    {
+        const uint64_t  upNano = Random(kMinDelayNano, maxUpNano);
+        const uint64_t  downNano = Random(kMinDelayNano, maxDownNano);
+        const uint64_t  remoteNano = Random(kMinRemoteNano, kMaxRemoteNano);
+        const uint64_t  sentNano = nowNano;
+        const uint64_t  remoteReceivedNano = static_cast<uint64_t>(sentNano + upNano + kOffsetNano);
+        const uint64_t  remoteSentNano = remoteReceivedNano + remoteNano;
+        const uint64_t  receivedNano = sentNano + upNano + remoteNano + downNano;
+        KorgSyncEstimatorAddBeacon(&estimator, sentNano, remoteReceivedNano, remoteSentNano, receivedNano);
+        KorgSyncTraceAppend(trace, receivedNano, kKorgSyncTrace_Beacon, sentNano, remoteSentNano, receivedNano, remoteReceivedNano);
+        ++numberOfBeacons;
+
+        if ((numberOfBeacons % kBeaconsPerStart) == 0)
+        {
+            KorgSyncTraceAppend(trace, receivedNano + 1, kKorgSyncTrace_Start, receivedNano + 1, 0,
+                                static_cast<int64_t>(estimator.timeDiff), estimator.worstDelay);
+        }
+        if (numberOfBeacons == kBurstAtBeacon)
+        {
+            KorgSyncEstimatorRequestBurst(&estimator);
+        }
+        KorgSyncTraceFlush(trace);
+        nowNano += KorgSyncEstimatorBeaconInterval(&estimator);
+    }
+    KorgSyncTraceDestroy(trace);
+    ::printf("%d beacons, true offset %.0f ns\n", numberOfBeacons, kOffsetNano);
+    return 0;
+}